@@ -0,0 +1,94 @@
+/*
+ * Compare the std::string returning finish methods of WKBWriter with the
+ * overloads appending to a caller-owned buffer. Reports time and heap
+ * allocations per geometry.
+ */
+
+#include "bench_util.hpp"
+
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+    constexpr int geometries = 1000000;
+    constexpr int points_per_geometry = 12;
+
+    void report(const char* name, double seconds, std::uint64_t allocs) {
+        std::printf("%-28s %8.1f ns/geometry %8.3f allocations/geometry\n",
+                    name, seconds * 1e9 / geometries,
+                    static_cast<double>(allocs) / geometries);
+    }
+
+    template <typename TFunc>
+    void run(const char* name, TFunc&& func) {
+        // warm up buffers so that only the steady state is measured
+        func(100);
+        const auto allocs_before = bench::allocations();
+        const bench::timer t;
+        func(geometries);
+        const double seconds = t.elapsed();
+        report(name, seconds, bench::allocations() - allocs_before);
+    }
+
+    void add_points(wkbhpp::WKBWriter& writer, int n) {
+        for (int i = 0; i < points_per_geometry; ++i) {
+            writer.linestring_add_location(n + i * 0.5, n - i * 0.25);
+        }
+    }
+
+    void bench_output(wkbhpp::out_type otype) {
+        wkbhpp::WKBWriter writer{3857, wkbhpp::wkb_type::ewkb, otype};
+
+        run("linestring_finish(n)", [&writer](int count) {
+            std::size_t total = 0;
+            for (int n = 0; n < count; ++n) {
+                writer.linestring_start();
+                add_points(writer, n);
+                const std::string wkb{writer.linestring_finish(points_per_geometry)};
+                total += wkb.size();
+            }
+            bench::do_not_optimize(total);
+        });
+
+        std::string out;
+        run("linestring_finish(n, out)", [&writer, &out](int count) {
+            std::size_t total = 0;
+            for (int n = 0; n < count; ++n) {
+                out.clear();
+                writer.linestring_start();
+                add_points(writer, n);
+                writer.linestring_finish(points_per_geometry, out);
+                total += out.size();
+            }
+            bench::do_not_optimize(total);
+        });
+
+        run("linestring_add_locations", [&writer, &out](int count) {
+            double xy[2 * points_per_geometry];
+            std::size_t total = 0;
+            for (int n = 0; n < count; ++n) {
+                for (int i = 0; i < points_per_geometry; ++i) {
+                    xy[2 * i] = n + i * 0.5;
+                    xy[2 * i + 1] = n - i * 0.25;
+                }
+                out.clear();
+                writer.linestring_start();
+                writer.linestring_add_locations(xy, points_per_geometry);
+                writer.linestring_finish(points_per_geometry, out);
+                total += out.size();
+            }
+            bench::do_not_optimize(total);
+        });
+    }
+
+} // anonymous namespace
+
+int main() {
+    std::printf("binary output\n");
+    bench_output(wkbhpp::out_type::binary);
+    std::printf("hex output\n");
+    bench_output(wkbhpp::out_type::hex);
+}
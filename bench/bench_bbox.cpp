@@ -0,0 +1,97 @@
+/*
+ * Encoding polygons with the bounding box computed by the writer (fused)
+ * compared with encoding them without bounding box and with a separate
+ * pass over the coordinates afterwards.
+ */
+
+#include "bench_util.hpp"
+
+#include <wkbhpp/bbox.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr std::size_t rounds = 10;
+
+    using bbox_writer = wkbhpp::GenericWKBWriter<wkbhpp::dynamic_format, wkbhpp::geometry_bbox>;
+
+    struct ring {
+        std::vector<double> xy;
+        std::size_t size() const noexcept {
+            return xy.size() / 2;
+        }
+    };
+
+    void report(const char* name, double seconds, std::size_t points) {
+        std::printf("  %-16s %8.1f Mpoints/s\n", name, rounds * points / seconds / 1e6);
+    }
+
+    template <typename TWriter, typename TFunc>
+    double encode(TWriter& writer, const std::vector<ring>& rings, TFunc&& after_finish) {
+        std::string out;
+        const bench::timer t;
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (const auto& rg : rings) {
+                out.clear();
+                writer.polygon_start();
+                writer.polygon_outer_ring_start();
+                writer.polygon_add_locations(rg.xy.data(), rg.size());
+                writer.polygon_outer_ring_finish();
+                writer.polygon_finish(out);
+                after_finish(writer, rg);
+                bench::do_not_optimize(out.data());
+            }
+        }
+        return t.elapsed();
+    }
+
+    void bench_rings(const char* name, const std::vector<ring>& rings) {
+        std::size_t points = 0;
+        for (const auto& rg : rings) {
+            points += rg.size();
+        }
+        std::printf("%s (%zu rings, %zu points)\n", name, rings.size(), points);
+
+        wkbhpp::WKBWriter plain{4326, wkbhpp::wkb_type::ewkb};
+        report("no bbox", encode(plain, rings, [](const wkbhpp::WKBWriter&, const ring&) {}), points);
+
+        report("separate pass", encode(plain, rings, [](const wkbhpp::WKBWriter&, const ring& rg) {
+            wkbhpp::box b;
+            for (std::size_t i = 0; i < rg.xy.size(); i += 2) {
+                b.extend(rg.xy[i], rg.xy[i + 1]);
+            }
+            bench::do_not_optimize(b);
+        }), points);
+
+        bbox_writer fused{4326, wkbhpp::dynamic_format{wkbhpp::wkb_type::ewkb}};
+        report("fused", encode(fused, rings, [](const bbox_writer& w, const ring&) {
+            bench::do_not_optimize(w.bbox().geometry());
+        }), points);
+    }
+
+    std::vector<ring> make_rings(std::size_t count, std::size_t mean_size) {
+        std::mt19937 gen{42};
+        std::uniform_real_distribution<double> coordinate{-180.0, 180.0};
+        std::geometric_distribution<std::size_t> ring_size{1.0 / mean_size};
+        std::vector<ring> rings(count);
+        for (auto& rg : rings) {
+            const std::size_t n = 4 + ring_size(gen);
+            for (std::size_t j = 0; j < n; ++j) {
+                rg.xy.push_back(coordinate(gen));
+                rg.xy.push_back(coordinate(gen));
+            }
+        }
+        return rings;
+    }
+
+} // anonymous namespace
+
+int main() {
+    bench_rings("small rings", make_rings(200000, 10));
+    bench_rings("large rings", make_rings(200, 10000));
+}
@@ -0,0 +1,92 @@
+/*
+ * Byte swapping of coordinates: throughput of the byte_swap_doubles()
+ * implementations and of the in-place conversion of XDR linestrings to
+ * NDR with set_byte_order().
+ */
+
+#include "bench_util.hpp"
+
+#include <wkbhpp/transform.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+    const char* level_name(wkbhpp::detail::simd_level level) {
+        switch (level) {
+            case wkbhpp::detail::simd_level::sse2:
+                return "sse2";
+            case wkbhpp::detail::simd_level::ssse3:
+                return "ssse3";
+            case wkbhpp::detail::simd_level::avx2:
+                return "avx2";
+            default:
+                break;
+        }
+        return "scalar";
+    }
+
+    void bench_swap(wkbhpp::detail::simd_level level, std::size_t count) {
+        std::string data(count * sizeof(double), '\0');
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<char>(i * 31u);
+        }
+
+        const auto swap = wkbhpp::detail::byte_swapper(level);
+        const std::size_t iterations = (std::size_t(1) << 30u) / data.size();
+
+        const bench::timer t;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            swap(&data[0], data.data(), count);
+            bench::do_not_optimize(data[i % data.size()]);
+        }
+        const double seconds = t.elapsed();
+
+        std::printf("swap %-8s %10zu doubles %8.2f GB/s\n", level_name(level), count,
+                    static_cast<double>(iterations * data.size()) / seconds / 1e9);
+    }
+
+    void bench_set_byte_order(std::size_t points) {
+        wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary, wkbhpp::byte_order::xdr};
+        writer.linestring_start();
+        for (std::size_t i = 0; i < points; ++i) {
+            writer.linestring_add_location(static_cast<double>(i), -static_cast<double>(i));
+        }
+        std::string wkb = writer.linestring_finish(points);
+
+        const std::size_t iterations = (std::size_t(1) << 28u) / wkb.size();
+        const bench::timer t;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            // alternate between the byte orders so that every run swaps
+            wkbhpp::set_byte_order(wkb, i % 2 ? wkbhpp::byte_order::xdr : wkbhpp::byte_order::ndr);
+            bench::do_not_optimize(wkb[i % wkb.size()]);
+        }
+        const double seconds = t.elapsed();
+
+        std::printf("set_byte_order linestring %8zu points %8.2f GB/s\n", points,
+                    static_cast<double>(iterations * wkb.size()) / seconds / 1e9);
+    }
+
+} // anonymous namespace
+
+int main() {
+    const auto best = wkbhpp::detail::cpu_simd_level();
+    std::printf("CPU supports: %s\n", level_name(best));
+
+    for (const std::size_t count : {std::size_t(16), std::size_t(1024), std::size_t(1) << 17u}) {
+        for (const auto level : {wkbhpp::detail::simd_level::scalar,
+                                 wkbhpp::detail::simd_level::sse2,
+                                 wkbhpp::detail::simd_level::ssse3,
+                                 wkbhpp::detail::simd_level::avx2}) {
+            if (level <= best) {
+                bench_swap(level, count);
+            }
+        }
+    }
+
+    for (const std::size_t points : {std::size_t(8), std::size_t(100), std::size_t(10000)}) {
+        bench_set_byte_order(points);
+    }
+}
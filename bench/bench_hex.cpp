@@ -0,0 +1,89 @@
+/*
+ * Throughput of the HEX encoder and decoder implementations in GB/s of
+ * binary data.
+ */
+
+#include "bench_util.hpp"
+
+#include <wkbhpp/hex.hpp>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+    const char* level_name(wkbhpp::detail::simd_level level) {
+        switch (level) {
+            case wkbhpp::detail::simd_level::sse2:
+                return "sse2";
+            case wkbhpp::detail::simd_level::ssse3:
+                return "ssse3";
+            case wkbhpp::detail::simd_level::avx2:
+                return "avx2";
+            default:
+                break;
+        }
+        return "scalar";
+    }
+
+    void bench_encoder(wkbhpp::detail::simd_level level, std::size_t size) {
+        std::string data(size, '\0');
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(i * 31u);
+        }
+        std::string out(2 * size, ' ');
+
+        const auto encode = wkbhpp::detail::hex_encoder(level);
+        const std::size_t iterations = (std::size_t(1) << 30u) / size;
+
+        const bench::timer t;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            encode(&out[0], reinterpret_cast<const unsigned char*>(data.data()), size, wkbhpp::hex_case::upper);
+            bench::do_not_optimize(out[i % out.size()]);
+        }
+        const double seconds = t.elapsed();
+
+        std::printf("encode %-8s %10zu bytes %8.2f GB/s\n", level_name(level), size,
+                    static_cast<double>(iterations * size) / seconds / 1e9);
+    }
+
+    void bench_decoder(wkbhpp::detail::simd_level level, std::size_t size) {
+        std::string data(size, '\0');
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(i * 31u);
+        }
+        const std::string hex = wkbhpp::convert_to_hex(data);
+        std::string out(size, ' ');
+
+        const auto decode = wkbhpp::detail::hex_decoder(level);
+        const std::size_t iterations = (std::size_t(1) << 30u) / size;
+
+        const bench::timer t;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            bench::do_not_optimize(decode(&out[0], reinterpret_cast<const unsigned char*>(hex.data()), size));
+            bench::do_not_optimize(out[i % out.size()]);
+        }
+        const double seconds = t.elapsed();
+
+        std::printf("decode %-8s %10zu bytes %8.2f GB/s\n", level_name(level), size,
+                    static_cast<double>(iterations * size) / seconds / 1e9);
+    }
+
+} // anonymous namespace
+
+int main() {
+    const auto best = wkbhpp::detail::cpu_simd_level();
+    std::printf("CPU supports: %s\n", level_name(best));
+
+    for (const std::size_t size : {std::size_t(64), std::size_t(4096), std::size_t(1) << 20u}) {
+        for (const auto level : {wkbhpp::detail::simd_level::scalar,
+                                 wkbhpp::detail::simd_level::sse2,
+                                 wkbhpp::detail::simd_level::ssse3,
+                                 wkbhpp::detail::simd_level::avx2}) {
+            if (level <= best) {
+                bench_encoder(level, size);
+                bench_decoder(level, size);
+            }
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * Encoding polygons at several simplification levels: one Simplifier pass
+ * per level compared with a single pass of MultiLevelWriter.
+ */
+
+#include "bench_util.hpp"
+
+#include <wkbhpp/multi_level.hpp>
+#include <wkbhpp/simplify.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr std::size_t rounds = 5;
+
+    const std::vector<double> tolerances{0.00001, 0.0001, 0.001, 0.01, 0.1};
+
+    std::vector<std::vector<double>> make_rings(std::size_t count, std::size_t mean_size) {
+        std::mt19937 gen{42};
+        std::uniform_real_distribution<double> center{-170.0, 170.0};
+        std::uniform_real_distribution<double> noise{0.9, 1.1};
+        std::geometric_distribution<std::size_t> ring_size{1.0 / mean_size};
+        std::vector<std::vector<double>> rings(count);
+        for (auto& ring : rings) {
+            const double cx = center(gen);
+            const double cy = center(gen) / 2;
+            const std::size_t n = 4 + ring_size(gen);
+            for (std::size_t i = 0; i < n; ++i) {
+                const double a = 2 * 3.14159265358979323846 * i / n;
+                ring.push_back(cx + 0.5 * noise(gen) * std::cos(a));
+                ring.push_back(cy + 0.5 * noise(gen) * std::sin(a));
+            }
+            ring.push_back(ring[0]);
+            ring.push_back(ring[1]);
+        }
+        return rings;
+    }
+
+    void report(const char* name, double seconds, std::size_t points) {
+        std::printf("  %-16s %8.1f Mpoints/s (input points)\n", name, rounds * points / seconds / 1e6);
+    }
+
+    void bench_rings(const char* name, const std::vector<std::vector<double>>& rings) {
+        std::size_t points = 0;
+        for (const auto& ring : rings) {
+            points += ring.size() / 2;
+        }
+        std::printf("%s (%zu rings, %zu points, %zu levels)\n", name, rings.size(), points, tolerances.size());
+
+        const wkbhpp::WKBWriter prototype{4326, wkbhpp::wkb_type::ewkb};
+        std::vector<std::string> out(tolerances.size());
+        {
+            std::vector<wkbhpp::WKBWriter> writers(tolerances.size(), prototype);
+            std::vector<wkbhpp::Simplifier<wkbhpp::WKBWriter>> simplifiers;
+            for (std::size_t i = 0; i < tolerances.size(); ++i) {
+                simplifiers.emplace_back(writers[i], tolerances[i]);
+            }
+            const bench::timer t;
+            for (std::size_t r = 0; r < rounds; ++r) {
+                for (const auto& ring : rings) {
+                    for (std::size_t i = 0; i < simplifiers.size(); ++i) {
+                        auto& s = simplifiers[i];
+                        out[i].clear();
+                        s.polygon_start();
+                        s.polygon_outer_ring_start();
+                        s.polygon_add_locations(ring.data(), ring.size() / 2);
+                        s.polygon_outer_ring_finish();
+                        s.polygon_finish(out[i]);
+                    }
+                }
+            }
+            report("per level", t.elapsed(), points);
+        }
+        {
+            wkbhpp::MultiLevelWriter<wkbhpp::WKBWriter> levels{prototype, tolerances};
+            const bench::timer t;
+            for (std::size_t r = 0; r < rounds; ++r) {
+                for (const auto& ring : rings) {
+                    for (auto& o : out) {
+                        o.clear();
+                    }
+                    levels.polygon_start();
+                    levels.polygon_outer_ring_start();
+                    levels.polygon_add_locations(ring.data(), ring.size() / 2);
+                    levels.polygon_outer_ring_finish();
+                    levels.polygon_finish(out);
+                }
+            }
+            report("multi level", t.elapsed(), points);
+        }
+    }
+
+} // anonymous namespace
+
+int main() {
+    bench_rings("small rings", make_rings(100000, 20));
+    bench_rings("large rings", make_rings(100, 20000));
+}
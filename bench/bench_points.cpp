@@ -0,0 +1,77 @@
+/*
+ * Encoding many points: one make_point() call per point compared with the
+ * batch encoder encode_points().
+ */
+
+#include "bench_util.hpp"
+
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr std::size_t points = 4000000;
+
+    void report(const char* name, double seconds, std::size_t bytes) {
+        std::printf("  %-24s %8.1f Mpoints/s %8.1f MB/s\n", name, points / seconds / 1e6, bytes / seconds / 1e6);
+    }
+
+    template <typename TWriter>
+    void bench_writer(const char* name, const TWriter& writer, const std::vector<double>& xy,
+                      const std::vector<double>& x, const std::vector<double>& y) {
+        std::printf("%s\n", name);
+        std::string out;
+        out.reserve(points * wkbhpp::WKBWriter::max_point_size);
+
+        {
+            std::size_t bytes = 0;
+            const bench::timer t;
+            for (std::size_t i = 0; i < points; ++i) {
+                const std::string point{writer.make_point(xy[2 * i], xy[2 * i + 1])};
+                bytes += point.size();
+            }
+            report("make_point", t.elapsed(), bytes);
+        }
+        {
+            out.clear();
+            const bench::timer t;
+            for (std::size_t i = 0; i < points; ++i) {
+                writer.make_point(xy[2 * i], xy[2 * i + 1], out);
+            }
+            report("make_point(out)", t.elapsed(), out.size());
+        }
+        {
+            out.clear();
+            const bench::timer t;
+            writer.encode_points(xy.data(), points, out);
+            report("encode_points (x/y pairs)", t.elapsed(), out.size());
+        }
+        {
+            out.clear();
+            const bench::timer t;
+            writer.encode_points(x.data(), y.data(), points, out);
+            report("encode_points (x[], y[])", t.elapsed(), out.size());
+        }
+        bench::do_not_optimize(out.data());
+    }
+
+} // anonymous namespace
+
+int main() {
+    std::vector<double> xy;
+    std::vector<double> x;
+    std::vector<double> y;
+    for (std::size_t i = 0; i < points; ++i) {
+        x.push_back(static_cast<double>(i % 36000) * 0.01);
+        y.push_back(static_cast<double>(i % 18000) * 0.01);
+        xy.push_back(x.back());
+        xy.push_back(y.back());
+    }
+
+    bench_writer("EWKB binary", wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary>{4326}, xy, x, y);
+    bench_writer("EWKB hex", wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex>{4326}, xy, x, y);
+    bench_writer("WKB binary (WKBWriter)", wkbhpp::WKBWriter{4326}, xy, x, y);
+}
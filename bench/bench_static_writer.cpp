@@ -0,0 +1,99 @@
+/*
+ * Compare WKBWriter (format checked at runtime) with BasicWKBWriter (format
+ * fixed at compile time) on small geometries, where the per geometry
+ * overhead dominates.
+ */
+
+#include "bench_util.hpp"
+
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+    constexpr int geometries = 2000000;
+
+    template <typename TWriter>
+    double bench_points(TWriter& writer, std::string& out) {
+        const bench::timer t;
+        for (int n = 0; n < geometries; ++n) {
+            out.clear();
+            writer.make_point(n * 0.5, n * 0.25, out);
+            bench::do_not_optimize(out.data());
+        }
+        return t.elapsed();
+    }
+
+    template <typename TWriter>
+    double bench_points_into(TWriter& writer, std::string& /*out*/) {
+        char buffer[wkbhpp::WKBWriter::max_point_size];
+        const bench::timer t;
+        for (int n = 0; n < geometries; ++n) {
+            writer.make_point_into(n * 0.5, n * 0.25, buffer);
+            bench::do_not_optimize(buffer);
+        }
+        return t.elapsed();
+    }
+
+    template <typename TWriter>
+    double bench_linestrings(TWriter& writer, std::string& out) {
+        const bench::timer t;
+        for (int n = 0; n < geometries; ++n) {
+            out.clear();
+            writer.linestring_start();
+            writer.linestring_add_location(n, n * 0.5);
+            writer.linestring_add_location(n + 1.0, n * 0.25);
+            writer.linestring_finish(2, out);
+            bench::do_not_optimize(out.data());
+        }
+        return t.elapsed();
+    }
+
+    template <typename TWriter>
+    double bench_polygons(TWriter& writer, std::string& out) {
+        const bench::timer t;
+        for (int n = 0; n < geometries; ++n) {
+            out.clear();
+            writer.polygon_start();
+            writer.polygon_outer_ring_start();
+            writer.polygon_add_location(n, n);
+            writer.polygon_add_location(n + 1.0, n);
+            writer.polygon_add_location(n + 1.0, n + 1.0);
+            writer.polygon_add_location(n, n + 1.0);
+            writer.polygon_add_location(n, n);
+            writer.polygon_outer_ring_finish();
+            writer.polygon_finish(out);
+            bench::do_not_optimize(out.data());
+        }
+        return t.elapsed();
+    }
+
+    void report(const char* name, double dynamic_seconds, double static_seconds) {
+        std::printf("%-12s WKBWriter %7.1f ns/geometry   BasicWKBWriter %7.1f ns/geometry\n", name,
+                    dynamic_seconds * 1e9 / geometries, static_seconds * 1e9 / geometries);
+    }
+
+    template <wkbhpp::out_type TOutType>
+    void bench_output(const char* name) {
+        wkbhpp::WKBWriter dynamic_writer{3857, wkbhpp::wkb_type::ewkb, TOutType};
+        wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, TOutType> static_writer{3857};
+        std::string out;
+
+        std::printf("%s\n", name);
+        report("point", bench_points(dynamic_writer, out), bench_points(static_writer, out));
+        const auto allocations = bench::allocations();
+        report("point_into", bench_points_into(dynamic_writer, out), bench_points_into(static_writer, out));
+        std::printf("%-12s %llu heap allocations\n", "point_into",
+                    static_cast<unsigned long long>(bench::allocations() - allocations));
+        report("linestring", bench_linestrings(dynamic_writer, out), bench_linestrings(static_writer, out));
+        report("polygon", bench_polygons(dynamic_writer, out), bench_polygons(static_writer, out));
+    }
+
+} // anonymous namespace
+
+int main() {
+    bench_output<wkbhpp::out_type::binary>("EWKB binary");
+    bench_output<wkbhpp::out_type::hex>("EWKB hex");
+}
@@ -0,0 +1,82 @@
+/*
+ * Structural validation of a column of WKB geometries compared with
+ * copying the column with memcpy.
+ */
+
+#include "bench_util.hpp"
+
+#include <wkbhpp/validate.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr std::size_t rounds = 10;
+
+    void report(const char* name, double seconds, std::size_t geometries, std::size_t bytes) {
+        std::printf("  %-12s %8.1f Mgeom/s %9.1f MB/s\n", name,
+                    rounds * geometries / seconds / 1e6, rounds * bytes / seconds / 1e6);
+    }
+
+    void bench_column(const char* name, const std::string& data, const std::vector<int64_t>& offsets) {
+        const std::size_t count = offsets.size() - 1;
+        std::printf("%s (%zu geometries, %.1f MB)\n", name, count, data.size() / 1e6);
+        {
+            std::string copy(data.size(), '\0');
+            const bench::timer t;
+            for (std::size_t r = 0; r < rounds; ++r) {
+                std::memcpy(&copy[0], data.data(), data.size());
+                bench::do_not_optimize(copy.data());
+            }
+            report("memcpy", t.elapsed(), count, data.size());
+        }
+        {
+            std::size_t invalid = 0;
+            const bench::timer t;
+            for (std::size_t r = 0; r < rounds; ++r) {
+                invalid += wkbhpp::validate(data.data(), offsets.data(), count).size();
+            }
+            report("validate", t.elapsed(), count, data.size());
+            if (invalid != 0) {
+                std::printf("  unexpected invalid geometries: %zu\n", invalid);
+            }
+        }
+    }
+
+} // anonymous namespace
+
+int main() {
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<double> coordinate{-180.0, 180.0};
+    std::geometric_distribution<std::size_t> ring_size{0.1};
+
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb};
+
+    std::string points;
+    std::vector<int64_t> point_offsets{0};
+    for (std::size_t i = 0; i < 1000000; ++i) {
+        writer.make_point(coordinate(gen), coordinate(gen), points);
+        point_offsets.push_back(static_cast<int64_t>(points.size()));
+    }
+    bench_column("points", points, point_offsets);
+
+    std::string polygons;
+    std::vector<int64_t> polygon_offsets{0};
+    for (std::size_t i = 0; i < 200000; ++i) {
+        writer.polygon_start();
+        writer.polygon_outer_ring_start();
+        const std::size_t n = 4 + ring_size(gen);
+        for (std::size_t j = 0; j < n; ++j) {
+            writer.polygon_add_location(coordinate(gen), coordinate(gen));
+        }
+        writer.polygon_outer_ring_finish();
+        writer.polygon_finish(polygons);
+        polygon_offsets.push_back(static_cast<int64_t>(polygons.size()));
+    }
+    bench_column("polygons", polygons, polygon_offsets);
+}
@@ -0,0 +1,377 @@
+/*
+ * Benchmark suite for WKBWriter.
+ *
+ * Encodes synthetic geometries whose sizes follow the distributions found
+ * in OpenStreetMap data (many small buildings and short ways, a long tail
+ * of huge polygons) for every geometry type, WKB/EWKB and binary/HEX
+ * output, both point by point and with the bulk methods.
+ *
+ * Usage: bench_wkbwriter [--json FILE] [--scale FACTOR]
+ *
+ * Reports geometries/s, points/s, output MB/s and heap allocations per
+ * geometry. With --json the results are also written to FILE so that
+ * runs can be compared.
+ */
+
+#include "bench_util.hpp"
+
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    /**
+     * Coordinates of all rings/linestrings of a set of geometries. A
+     * geometry consists of polygons, a polygon of rings.
+     */
+    struct dataset {
+        std::vector<double> xy;
+        std::vector<std::size_t> ring_offsets{0};          // into xy, in points
+        std::vector<std::size_t> polygon_ring_offsets{0};  // into ring_offsets
+        std::vector<std::size_t> geometry_polygon_offsets{0}; // into polygon_ring_offsets
+
+        std::size_t geometries() const {
+            return geometry_polygon_offsets.size() - 1;
+        }
+
+        std::size_t points() const {
+            return xy.size() / 2;
+        }
+    };
+
+    class generator {
+
+        std::mt19937 m_gen{20190827};
+
+    public:
+
+        /**
+         * Number of points of a way or ring: log-normal distribution with
+         * the given median, clamped to [min, max].
+         */
+        std::size_t size(double median, double sigma, std::size_t min, std::size_t max) {
+            std::lognormal_distribution<double> dist{std::log(median), sigma};
+            const auto n = static_cast<std::size_t>(dist(m_gen));
+            return std::min(std::max(n, min), max);
+        }
+
+        bool chance(double p) {
+            return std::uniform_real_distribution<double>{0.0, 1.0}(m_gen) < p;
+        }
+
+        double coordinate(double range) {
+            return std::uniform_real_distribution<double>{-range, range}(m_gen);
+        }
+
+        void ring(dataset& data, std::size_t n, double cx, double cy, double radius) {
+            for (std::size_t i = 0; i + 1 < n; ++i) {
+                const double angle = 2 * M_PI * static_cast<double>(i) / static_cast<double>(n - 1);
+                data.xy.push_back(cx + radius * std::cos(angle));
+                data.xy.push_back(cy + radius * std::sin(angle));
+            }
+            data.xy.push_back(cx + radius);
+            data.xy.push_back(cy);
+            data.ring_offsets.push_back(data.points());
+        }
+
+        void linestring(dataset& data, std::size_t n) {
+            double x = coordinate(2e7);
+            double y = coordinate(2e7);
+            for (std::size_t i = 0; i < n; ++i) {
+                x += coordinate(20.0);
+                y += coordinate(20.0);
+                data.xy.push_back(x);
+                data.xy.push_back(y);
+            }
+            data.ring_offsets.push_back(data.points());
+        }
+
+        void polygon(dataset& data, double median, double sigma, std::size_t max) {
+            const double cx = coordinate(2e7);
+            const double cy = coordinate(2e7);
+            ring(data, size(median, sigma, 4, max), cx, cy, 100.0);
+            // about 5% of the polygons have holes
+            if (chance(0.05)) {
+                const std::size_t holes = size(1.5, 1.0, 1, 50);
+                for (std::size_t i = 0; i < holes; ++i) {
+                    ring(data, size(median, sigma, 4, max), cx + coordinate(50.0), cy + coordinate(50.0), 1.0);
+                }
+            }
+            data.polygon_ring_offsets.push_back(data.ring_offsets.size() - 1);
+        }
+
+    }; // class generator
+
+    dataset make_points(std::size_t count) {
+        generator gen;
+        dataset data;
+        for (std::size_t i = 0; i < count; ++i) {
+            data.xy.push_back(gen.coordinate(180.0));
+            data.xy.push_back(gen.coordinate(90.0));
+            data.ring_offsets.push_back(data.points());
+            data.polygon_ring_offsets.push_back(data.ring_offsets.size() - 1);
+            data.geometry_polygon_offsets.push_back(data.polygon_ring_offsets.size() - 1);
+        }
+        return data;
+    }
+
+    dataset make_linestrings(std::size_t count) {
+        // ways: median of 6 nodes, long tail up to the API limit of 2000
+        generator gen;
+        dataset data;
+        for (std::size_t i = 0; i < count; ++i) {
+            gen.linestring(data, gen.size(6.0, 1.0, 2, 2000));
+            data.polygon_ring_offsets.push_back(data.ring_offsets.size() - 1);
+            data.geometry_polygon_offsets.push_back(data.polygon_ring_offsets.size() - 1);
+        }
+        return data;
+    }
+
+    dataset make_polygons(std::size_t count) {
+        // mostly buildings with 5 to 10 nodes
+        generator gen;
+        dataset data;
+        for (std::size_t i = 0; i < count; ++i) {
+            gen.polygon(data, 6.0, 0.6, 2000);
+            data.geometry_polygon_offsets.push_back(data.polygon_ring_offsets.size() - 1);
+        }
+        return data;
+    }
+
+    dataset make_multipolygons(std::size_t count) {
+        // multipolygon relations: few polygons each, large rings and an
+        // occasional coastline-sized ring
+        generator gen;
+        dataset data;
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t polygons = gen.size(1.5, 1.2, 1, 200);
+            for (std::size_t p = 0; p < polygons; ++p) {
+                gen.polygon(data, 40.0, 1.5, gen.chance(0.001) ? 100000 : 5000);
+            }
+            data.geometry_polygon_offsets.push_back(data.polygon_ring_offsets.size() - 1);
+        }
+        return data;
+    }
+
+    enum class geometry_kind {
+        point,
+        linestring,
+        polygon,
+        multipolygon
+    };
+
+    const char* kind_name(geometry_kind kind) {
+        switch (kind) {
+            case geometry_kind::point:
+                return "point";
+            case geometry_kind::linestring:
+                return "linestring";
+            case geometry_kind::polygon:
+                return "polygon";
+            default:
+                break;
+        }
+        return "multipolygon";
+    }
+
+    struct result {
+        std::string geometry;
+        std::string wkb;
+        std::string output;
+        std::string api;
+        std::size_t geometries;
+        std::size_t points;
+        std::size_t bytes;
+        std::uint64_t allocations;
+        double seconds;
+    };
+
+    void encode_rings(wkbhpp::WKBWriter& writer, const dataset& data, std::size_t polygon, bool bulk) {
+        for (std::size_t r = data.polygon_ring_offsets[polygon]; r < data.polygon_ring_offsets[polygon + 1]; ++r) {
+            const bool outer = r == data.polygon_ring_offsets[polygon];
+            if (outer) {
+                writer.multipolygon_outer_ring_start();
+            } else {
+                writer.multipolygon_inner_ring_start();
+            }
+            const std::size_t first = data.ring_offsets[r];
+            const std::size_t last = data.ring_offsets[r + 1];
+            if (bulk) {
+                writer.multipolygon_add_locations(data.xy.data() + 2 * first, last - first);
+            } else {
+                for (std::size_t i = first; i < last; ++i) {
+                    writer.multipolygon_add_location(data.xy[2 * i], data.xy[2 * i + 1]);
+                }
+            }
+            if (outer) {
+                writer.multipolygon_outer_ring_finish();
+            } else {
+                writer.multipolygon_inner_ring_finish();
+            }
+        }
+    }
+
+    /**
+     * Encode geometry g of the dataset and append it to out.
+     */
+    void encode(wkbhpp::WKBWriter& writer, geometry_kind kind, const dataset& data, std::size_t g, bool bulk, std::string& out) {
+        const std::size_t first_polygon = data.geometry_polygon_offsets[g];
+        const std::size_t first_ring = data.polygon_ring_offsets[first_polygon];
+        const std::size_t first = data.ring_offsets[first_ring];
+        const std::size_t last = data.ring_offsets[first_ring + 1];
+
+        switch (kind) {
+            case geometry_kind::point:
+                writer.make_point(data.xy[2 * first], data.xy[2 * first + 1], out);
+                break;
+            case geometry_kind::linestring:
+                writer.linestring_start();
+                if (bulk) {
+                    writer.linestring_add_locations(data.xy.data() + 2 * first, last - first);
+                } else {
+                    for (std::size_t i = first; i < last; ++i) {
+                        writer.linestring_add_location(data.xy[2 * i], data.xy[2 * i + 1]);
+                    }
+                }
+                writer.linestring_finish(last - first, out);
+                break;
+            case geometry_kind::polygon:
+                // Polygon rings are written by the same code as the rings of
+                // multipolygons, polygon_* only forwards to multipolygon_*.
+                writer.polygon_start();
+                encode_rings(writer, data, first_polygon, bulk);
+                writer.polygon_finish(out);
+                break;
+            case geometry_kind::multipolygon:
+                writer.multipolygon_start();
+                for (std::size_t p = first_polygon; p < data.geometry_polygon_offsets[g + 1]; ++p) {
+                    writer.multipolygon_polygon_start();
+                    encode_rings(writer, data, p, bulk);
+                    writer.multipolygon_polygon_finish();
+                }
+                writer.multipolygon_finish(out);
+                break;
+        }
+    }
+
+    result run(geometry_kind kind, const dataset& data, wkbhpp::wkb_type wtype, wkbhpp::out_type otype, bool bulk) {
+        wkbhpp::WKBWriter writer{3857, wtype, otype};
+        std::string out;
+
+        // The output is cleared every 1000 geometries like a COPY buffer
+        // would be flushed. Warm up once so that only the steady state is
+        // measured.
+        for (std::size_t g = 0; g < std::min<std::size_t>(data.geometries(), 1000); ++g) {
+            encode(writer, kind, data, g, bulk, out);
+        }
+        out.clear();
+
+        std::size_t bytes = 0;
+        const auto allocations = bench::allocations();
+        const bench::timer t;
+        for (std::size_t g = 0; g < data.geometries(); ++g) {
+            if (g % 1000 == 0) {
+                bytes += out.size();
+                out.clear();
+            }
+            encode(writer, kind, data, g, bulk, out);
+        }
+        bytes += out.size();
+        const double seconds = t.elapsed();
+
+        return result{kind_name(kind),
+                      wtype == wkbhpp::wkb_type::ewkb ? "ewkb" : "wkb",
+                      otype == wkbhpp::out_type::hex ? "hex" : "binary",
+                      bulk ? "bulk" : "stream",
+                      data.geometries(), data.points(), bytes,
+                      bench::allocations() - allocations, seconds};
+    }
+
+    void print(const result& r) {
+        std::printf("%-13s %-5s %-7s %-7s %10.0f geom/s %12.0f points/s %9.1f MB/s %7.3f alloc/geom\n",
+                    r.geometry.c_str(), r.wkb.c_str(), r.output.c_str(), r.api.c_str(),
+                    r.geometries / r.seconds, r.points / r.seconds, r.bytes / r.seconds / 1e6,
+                    static_cast<double>(r.allocations) / r.geometries);
+    }
+
+    void write_json(const char* filename, const std::vector<result>& results) {
+        FILE* file = std::fopen(filename, "w");
+        if (!file) {
+            std::perror(filename);
+            std::exit(1);
+        }
+        std::fprintf(file, "{\n  \"version\": \"%s\",\n  \"results\": [\n", WKBHPP_VERSION_STRING);
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const result& r = results[i];
+            std::fprintf(file,
+                         "    {\"geometry\": \"%s\", \"wkb_type\": \"%s\", \"out_type\": \"%s\", \"api\": \"%s\", "
+                         "\"geometries\": %zu, \"points\": %zu, \"bytes\": %zu, \"seconds\": %.6f, "
+                         "\"geometries_per_second\": %.1f, \"points_per_second\": %.1f, \"mb_per_second\": %.3f, "
+                         "\"allocations_per_geometry\": %.4f}%s\n",
+                         r.geometry.c_str(), r.wkb.c_str(), r.output.c_str(), r.api.c_str(),
+                         r.geometries, r.points, r.bytes, r.seconds,
+                         r.geometries / r.seconds, r.points / r.seconds, r.bytes / r.seconds / 1e6,
+                         static_cast<double>(r.allocations) / r.geometries,
+                         i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+        std::fclose(file);
+    }
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const char* json = nullptr;
+    double scale = 1.0;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--json") && i + 1 < argc) {
+            json = argv[++i];
+        } else if (!std::strcmp(argv[i], "--scale") && i + 1 < argc) {
+            scale = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--json FILE] [--scale FACTOR]\n", argv[0]);
+            return 1;
+        }
+    }
+    const auto count = [scale](double n) {
+        return std::max<std::size_t>(1, static_cast<std::size_t>(n * scale));
+    };
+
+    struct input {
+        geometry_kind kind;
+        dataset data;
+    };
+    const std::vector<input> inputs{
+        {geometry_kind::point, make_points(count(1000000))},
+        {geometry_kind::linestring, make_linestrings(count(200000))},
+        {geometry_kind::polygon, make_polygons(count(200000))},
+        {geometry_kind::multipolygon, make_multipolygons(count(5000))}
+    };
+
+    std::vector<result> results;
+    for (const auto& in : inputs) {
+        for (const auto wtype : {wkbhpp::wkb_type::wkb, wkbhpp::wkb_type::ewkb}) {
+            for (const auto otype : {wkbhpp::out_type::binary, wkbhpp::out_type::hex}) {
+                for (const bool bulk : {false, true}) {
+                    if (in.kind == geometry_kind::point && bulk) {
+                        continue;
+                    }
+                    results.push_back(run(in.kind, in.data, wtype, otype, bulk));
+                    print(results.back());
+                }
+            }
+        }
+    }
+
+    if (json) {
+        write_json(json, results);
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef WKBHPP_BENCH_UTIL_HPP
+#define WKBHPP_BENCH_UTIL_HPP
+
+/*
+ * Helpers shared by the benchmark programs.
+ *
+ * This header replaces the global operator new/delete in order to count heap
+ * allocations. Include it in exactly one translation unit per executable.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+
+    inline std::atomic<std::uint64_t>& allocation_counter() {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter;
+    }
+
+    /**
+     * Number of calls to operator new since program start.
+     */
+    inline std::uint64_t allocations() {
+        return allocation_counter().load(std::memory_order_relaxed);
+    }
+
+    class timer {
+
+        using clock = std::chrono::steady_clock;
+
+        clock::time_point m_start;
+
+    public:
+
+        timer() :
+            m_start(clock::now()) {
+        }
+
+        /**
+         * Seconds since construction of the timer.
+         */
+        double elapsed() const {
+            return std::chrono::duration<double>(clock::now() - m_start).count();
+        }
+
+    }; // class timer
+
+    /**
+     * Prevent the compiler from optimizing away a computed value.
+     */
+    template <typename T>
+    inline void do_not_optimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+} // namespace bench
+
+void* operator new(std::size_t size) {
+    bench::allocation_counter().fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#endif // WKBHPP_BENCH_UTIL_HPP
@@ -0,0 +1,423 @@
+#ifndef WKBHPP_BBOX_HPP
+#define WKBHPP_BBOX_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/detail/cpu.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace wkbhpp {
+
+    /**
+     * Axis-aligned bounding box. A default constructed box is empty.
+     */
+    struct box {
+        double min_x;
+        double min_y;
+        double max_x;
+        double max_y;
+
+        constexpr box() noexcept :
+            min_x(std::numeric_limits<double>::infinity()),
+            min_y(std::numeric_limits<double>::infinity()),
+            max_x(-std::numeric_limits<double>::infinity()),
+            max_y(-std::numeric_limits<double>::infinity()) {
+        }
+
+        constexpr box(const double minx, const double miny, const double maxx, const double maxy) noexcept :
+            min_x(minx),
+            min_y(miny),
+            max_x(maxx),
+            max_y(maxy) {
+        }
+
+        bool empty() const noexcept {
+            return !(min_x <= max_x);
+        }
+
+        /**
+         * Extend the box to include the point. NaN coordinates are ignored.
+         */
+        void extend(const double x, const double y) noexcept {
+            min_x = x < min_x ? x : min_x;
+            min_y = y < min_y ? y : min_y;
+            max_x = x > max_x ? x : max_x;
+            max_y = y > max_y ? y : max_y;
+        }
+
+        /**
+         * Extend the box to include another one. Empty boxes do not change
+         * it.
+         */
+        void extend(const box& other) noexcept {
+            min_x = other.min_x < min_x ? other.min_x : min_x;
+            min_y = other.min_y < min_y ? other.min_y : min_y;
+            max_x = other.max_x > max_x ? other.max_x : max_x;
+            max_y = other.max_y > max_y ? other.max_y : max_y;
+        }
+
+    }; // struct box
+
+    inline bool operator==(const box& lhs, const box& rhs) noexcept {
+        return lhs.min_x == rhs.min_x && lhs.min_y == rhs.min_y &&
+               lhs.max_x == rhs.max_x && lhs.max_y == rhs.max_y;
+    }
+
+    inline bool operator!=(const box& lhs, const box& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    namespace detail {
+
+        // Implementations of minmax_pairs() for different SIMD levels. They
+        // look at n pairs of doubles, stride doubles apart, and update the
+        // element-wise minimum (min[0], min[1]) and maximum (max[0],
+        // max[1]). NaN values are ignored.
+        using minmax_func = void (*)(const double*, std::size_t, std::size_t, double*, double*);
+
+        inline void minmax_pairs_scalar(const double* data, std::size_t n, std::size_t stride, double* min, double* max) noexcept {
+            for (std::size_t i = 0; i < n; ++i, data += stride) {
+                for (std::size_t j = 0; j < 2; ++j) {
+                    min[j] = data[j] < min[j] ? data[j] : min[j];
+                    max[j] = data[j] > max[j] ? data[j] : max[j];
+                }
+            }
+        }
+
+#if WKBHPP_SIMD_X86
+
+        // _mm_min_pd() and _mm_max_pd() return their second operand if one
+        // of the operands is NaN, so the accumulator is always passed last.
+
+        WKBHPP_TARGET("sse2")
+        inline void minmax_pairs_sse2(const double* data, std::size_t n, std::size_t stride, double* min, double* max) noexcept {
+            __m128d min0 = _mm_loadu_pd(min);
+            __m128d max0 = _mm_loadu_pd(max);
+            __m128d min1 = min0;
+            __m128d max1 = max0;
+            std::size_t i = 0;
+            for (; i + 2 <= n; i += 2, data += 2 * stride) {
+                const __m128d a = _mm_loadu_pd(data);
+                const __m128d b = _mm_loadu_pd(data + stride);
+                min0 = _mm_min_pd(a, min0);
+                max0 = _mm_max_pd(a, max0);
+                min1 = _mm_min_pd(b, min1);
+                max1 = _mm_max_pd(b, max1);
+            }
+            if (i < n) {
+                const __m128d a = _mm_loadu_pd(data);
+                min0 = _mm_min_pd(a, min0);
+                max0 = _mm_max_pd(a, max0);
+            }
+            _mm_storeu_pd(min, _mm_min_pd(min0, min1));
+            _mm_storeu_pd(max, _mm_max_pd(max0, max1));
+        }
+
+        /**
+         * Consecutive pairs (stride 2) are read four at a time, other
+         * strides use the SSE2 version.
+         */
+        WKBHPP_TARGET("avx2")
+        inline void minmax_pairs_avx2(const double* data, std::size_t n, std::size_t stride, double* min, double* max) noexcept {
+            if (stride != 2) {
+                minmax_pairs_sse2(data, n, stride, min, max);
+                return;
+            }
+            const __m128d min_init = _mm_loadu_pd(min);
+            const __m128d max_init = _mm_loadu_pd(max);
+            __m256d min0 = _mm256_set_m128d(min_init, min_init);
+            __m256d max0 = _mm256_set_m128d(max_init, max_init);
+            __m256d min1 = min0;
+            __m256d max1 = max0;
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4, data += 8) {
+                const __m256d a = _mm256_loadu_pd(data);
+                const __m256d b = _mm256_loadu_pd(data + 4);
+                min0 = _mm256_min_pd(a, min0);
+                max0 = _mm256_max_pd(a, max0);
+                min1 = _mm256_min_pd(b, min1);
+                max1 = _mm256_max_pd(b, max1);
+            }
+            min0 = _mm256_min_pd(min0, min1);
+            max0 = _mm256_max_pd(max0, max1);
+            _mm_storeu_pd(min, _mm_min_pd(_mm256_castpd256_pd128(min0), _mm256_extractf128_pd(min0, 1)));
+            _mm_storeu_pd(max, _mm_max_pd(_mm256_castpd256_pd128(max0), _mm256_extractf128_pd(max0, 1)));
+            minmax_pairs_sse2(data, n - i, 2, min, max);
+        }
+
+#endif
+
+        /**
+         * Get the min/max function for the given SIMD level, see
+         * hex_encoder().
+         */
+        inline minmax_func minmax_finder(simd_level level) noexcept {
+#if WKBHPP_SIMD_X86
+            switch (level) {
+                case simd_level::avx2:
+                    return minmax_pairs_avx2;
+                case simd_level::ssse3:
+                case simd_level::sse2:
+                    return minmax_pairs_sse2;
+                default:
+                    break;
+            }
+#else
+            (void)level;
+#endif
+            return minmax_pairs_scalar;
+        }
+
+        inline minmax_func best_minmax_finder() noexcept {
+            static const minmax_func func = minmax_finder(cpu_simd_level());
+            return func;
+        }
+
+        /**
+         * Update min and max with n pairs of doubles, stride doubles apart.
+         * Runs of more than a few pairs use the best SIMD implementation
+         * for the CPU.
+         */
+        inline void minmax_pairs(const double* data, std::size_t n, std::size_t stride, double* min, double* max) noexcept {
+            if (n < 8) {
+                minmax_pairs_scalar(data, n, stride, min, max);
+                return;
+            }
+            best_minmax_finder()(data, n, stride, min, max);
+        }
+
+        /**
+         * Extend b by n points of stride interleaved coordinates each (x
+         * and y first).
+         */
+        inline void extend_box(box& b, const double* coords, std::size_t n, std::size_t stride) noexcept {
+            double min[2] = {b.min_x, b.min_y};
+            double max[2] = {b.max_x, b.max_y};
+            minmax_pairs(coords, n, stride, min, max);
+            b = box{min[0], min[1], max[0], max[1]};
+        }
+
+        /**
+         * Extend b by n points given as separate x and y arrays. Each array
+         * is processed as pairs of consecutive values.
+         */
+        inline void extend_box(box& b, const double* x, const double* y, std::size_t n) noexcept {
+            double min_x[2] = {b.min_x, b.min_x};
+            double max_x[2] = {b.max_x, b.max_x};
+            double min_y[2] = {b.min_y, b.min_y};
+            double max_y[2] = {b.max_y, b.max_y};
+            minmax_pairs(x, n / 2, 2, min_x, max_x);
+            minmax_pairs(y, n / 2, 2, min_y, max_y);
+            b = box{min_x[0], min_y[0], max_x[0], max_y[0]};
+            b.extend(box{min_x[1], min_y[1], max_x[1], max_y[1]});
+            if (n % 2 != 0) {
+                b.extend(x[n - 1], y[n - 1]);
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * Bounding box policy of GenericWKBWriter which does nothing. All
+     * calls are inlined away, so a writer with this policy (the default)
+     * is as fast as one without bounding box support.
+     *
+     * A policy gets all points added to the geometry that is being built
+     * and is told where linestrings, rings and polygons start and end.
+     * reset() is called when a new outermost geometry starts. The metrics
+     * policies (see metrics.hpp) have the same hooks.
+     */
+    struct no_bbox {
+
+        void reset() noexcept {
+        }
+
+        void add_point(double /*x*/, double /*y*/) noexcept {
+        }
+
+        void add_points(const double* /*coords*/, std::size_t /*n*/, std::size_t /*stride*/) noexcept {
+        }
+
+        void add_points(const double* /*x*/, const double* /*y*/, std::size_t /*n*/) noexcept {
+        }
+
+        void linestring_start() noexcept {
+        }
+
+        void linestring_finish() noexcept {
+        }
+
+        void ring_start() noexcept {
+        }
+
+        void ring_finish() noexcept {
+        }
+
+        void polygon_start() noexcept {
+        }
+
+        void polygon_finish() noexcept {
+        }
+
+    }; // struct no_bbox
+
+    /**
+     * Bounding box policy which tracks the bounding box of the whole
+     * geometry.
+     */
+    class geometry_bbox : public no_bbox {
+
+        box m_geometry;
+
+    public:
+
+        void reset() noexcept {
+            m_geometry = box{};
+        }
+
+        void add_point(const double x, const double y) noexcept {
+            m_geometry.extend(x, y);
+        }
+
+        void add_points(const double* coords, std::size_t n, std::size_t stride) noexcept {
+            detail::extend_box(m_geometry, coords, n, stride);
+        }
+
+        void add_points(const double* x, const double* y, std::size_t n) noexcept {
+            detail::extend_box(m_geometry, x, y, n);
+        }
+
+        /**
+         * Bounding box of the geometry built last (or being built).
+         */
+        const box& geometry() const noexcept {
+            return m_geometry;
+        }
+
+    }; // class geometry_bbox
+
+    /**
+     * Bounding box policy which tracks the bounding boxes of the whole
+     * geometry, of each ring and of each polygon (of a Polygon or
+     * MultiPolygon or inside a GeometryCollection). The vectors keep their
+     * capacity between geometries.
+     */
+    class detailed_bbox {
+
+        // points since the last ring, added to m_geometry when needed
+        box m_current;
+        box m_geometry;
+        box m_polygon;
+        std::vector<box> m_rings;
+        std::vector<box> m_polygons;
+
+    public:
+
+        void reset() noexcept {
+            m_current = box{};
+            m_geometry = box{};
+            m_rings.clear();
+            m_polygons.clear();
+        }
+
+        void add_point(const double x, const double y) noexcept {
+            m_current.extend(x, y);
+        }
+
+        void add_points(const double* coords, std::size_t n, std::size_t stride) noexcept {
+            detail::extend_box(m_current, coords, n, stride);
+        }
+
+        void add_points(const double* x, const double* y, std::size_t n) noexcept {
+            detail::extend_box(m_current, x, y, n);
+        }
+
+        // points of linestrings only count for geometry()
+        void linestring_start() noexcept {
+        }
+
+        void linestring_finish() noexcept {
+        }
+
+        void ring_start() noexcept {
+            m_geometry.extend(m_current);
+            m_current = box{};
+        }
+
+        void ring_finish() {
+            m_rings.push_back(m_current);
+            m_polygon.extend(m_current);
+            m_geometry.extend(m_current);
+            m_current = box{};
+        }
+
+        void polygon_start() noexcept {
+            m_polygon = box{};
+        }
+
+        void polygon_finish() {
+            m_polygons.push_back(m_polygon);
+        }
+
+        /**
+         * Bounding box of the geometry built last (or being built).
+         */
+        box geometry() const noexcept {
+            box result = m_geometry;
+            result.extend(m_current);
+            return result;
+        }
+
+        /**
+         * Bounding boxes of all rings in the order they were added.
+         */
+        const std::vector<box>& rings() const noexcept {
+            return m_rings;
+        }
+
+        /**
+         * Bounding boxes of all polygons in the order they were added.
+         */
+        const std::vector<box>& polygons() const noexcept {
+            return m_polygons;
+        }
+
+    }; // class detailed_bbox
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_BBOX_HPP */
@@ -0,0 +1,1078 @@
+#ifndef WKBHPP_CLIP_HPP
+#define WKBHPP_CLIP_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/bbox.hpp>
+#include <wkbhpp/error.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wkbhpp {
+
+    namespace detail {
+
+        /**
+         * Buffers reused by the clipping functions.
+         */
+        struct clip_scratch {
+            // clipped points, interleaved
+            std::vector<double> out;
+
+            // end of each piece of a clipped linestring, in points
+            std::vector<std::size_t> ends;
+        };
+
+        enum class box_relation : uint8_t {
+            disjoint = 0,
+            inside   = 1,
+            crossing = 2
+        }; // enum class box_relation
+
+        /**
+         * Position of the box b relative to the clip box. An empty box
+         * is disjoint.
+         */
+        inline box_relation relate(const box& clip, const box& b) noexcept {
+            if (b.empty() || b.max_x < clip.min_x || b.min_x > clip.max_x ||
+                b.max_y < clip.min_y || b.min_y > clip.max_y) {
+                return box_relation::disjoint;
+            }
+            if (b.min_x >= clip.min_x && b.max_x <= clip.max_x &&
+                b.min_y >= clip.min_y && b.max_y <= clip.max_y) {
+                return box_relation::inside;
+            }
+            return box_relation::crossing;
+        }
+
+        /**
+         * Append the point a + t * (b - a) with all its coordinates.
+         * Z and M are interpolated like X and Y.
+         */
+        inline void push_between(std::vector<double>& out, const double* a, const double* b, const double t,
+                                 const std::size_t stride) {
+            if (t == 0.0) {
+                out.insert(out.end(), a, a + stride);
+            } else if (t == 1.0) {
+                out.insert(out.end(), b, b + stride);
+            } else {
+                for (std::size_t i = 0; i < stride; ++i) {
+                    out.push_back(a[i] + t * (b[i] - a[i]));
+                }
+            }
+        }
+
+        /**
+         * Clip the segment from a to b with Liang-Barsky.
+         *
+         * @returns false if no part of the segment is inside, otherwise
+         *          the part inside runs from t0 to t1
+         */
+        inline bool clip_segment(const box& clip, const double* a, const double* b, double& t0, double& t1) noexcept {
+            const double dx = b[0] - a[0];
+            const double dy = b[1] - a[1];
+            const double p[4] = {-dx, dx, -dy, dy};
+            const double q[4] = {a[0] - clip.min_x, clip.max_x - a[0], a[1] - clip.min_y, clip.max_y - a[1]};
+            t0 = 0.0;
+            t1 = 1.0;
+            for (int k = 0; k < 4; ++k) {
+                if (p[k] == 0.0) {
+                    if (q[k] < 0.0) {
+                        return false;
+                    }
+                } else {
+                    const double r = q[k] / p[k];
+                    if (p[k] < 0.0) {
+                        if (r > t1) {
+                            return false;
+                        }
+                        if (r > t0) {
+                            t0 = r;
+                        }
+                    } else {
+                        if (r < t0) {
+                            return false;
+                        }
+                        if (r < t1) {
+                            t1 = r;
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Clip a linestring of n points. Every time the line leaves the
+         * box a new piece starts. The points of the pieces end up in
+         * scratch.out, the end of each piece in scratch.ends. Pieces
+         * which only touch the box in a single point are dropped, and so
+         * are repeated points.
+         *
+         * @returns the number of pieces
+         */
+        inline std::size_t clip_linestring(const double* coords, const std::size_t n, const std::size_t stride,
+                                           const box& clip, clip_scratch& scratch) {
+            scratch.out.clear();
+            scratch.ends.clear();
+            bool open = false;
+            for (std::size_t i = 1; i < n; ++i) {
+                const double* a = coords + (i - 1) * stride;
+                const double* b = a + stride;
+                if (a[0] == b[0] && a[1] == b[1]) {
+                    continue;
+                }
+                double t0;
+                double t1;
+                if (!clip_segment(clip, a, b, t0, t1)) {
+                    if (open) {
+                        scratch.ends.push_back(scratch.out.size() / stride);
+                        open = false;
+                    }
+                    continue;
+                }
+                if (!open) {
+                    if (t0 == t1) {
+                        continue;
+                    }
+                    push_between(scratch.out, a, b, t0, stride);
+                    open = true;
+                }
+                push_between(scratch.out, a, b, t1, stride);
+                if (t1 < 1.0) {
+                    scratch.ends.push_back(scratch.out.size() / stride);
+                    open = false;
+                }
+            }
+            if (open) {
+                scratch.ends.push_back(scratch.out.size() / stride);
+            }
+            return scratch.ends.size();
+        }
+
+        /**
+         * Points of one or more polygons.
+         */
+        struct polygon_list {
+            std::vector<double> coords;
+
+            // end of each ring, in points
+            std::vector<std::size_t> ring_ends;
+
+            // end of each polygon, in rings; the outer ring comes first
+            std::vector<std::size_t> polygon_ends;
+
+            void clear() noexcept {
+                coords.clear();
+                ring_ends.clear();
+                polygon_ends.clear();
+            }
+
+            std::size_t ring_begin(const std::size_t ring) const noexcept {
+                return ring == 0 ? 0 : ring_ends[ring - 1];
+            }
+
+            std::size_t polygon_begin(const std::size_t polygon) const noexcept {
+                return polygon == 0 ? 0 : polygon_ends[polygon - 1];
+            }
+        };
+
+        /**
+         * Part of a ring on the kept side of a cut line. It starts and
+         * ends on the line.
+         */
+        struct ring_chain {
+            // points in half_plane_scratch::chain_coords
+            std::size_t begin;
+            std::size_t end;
+
+            // positions of the first and last point along the line
+            double entry;
+            double exit;
+        };
+
+        /**
+         * Buffers reused by clip_half_plane().
+         */
+        struct half_plane_scratch {
+            std::vector<double> chain_coords;
+            std::vector<ring_chain> chains;
+
+            // position along the line and chain index * 2 + 1 for an
+            // exit, * 2 for an entry
+            std::vector<std::pair<double, std::size_t>> crossings;
+
+            std::vector<std::size_t> next;
+            std::vector<char> visited;
+
+            // outer rings built from the chains
+            std::vector<double> ring_coords;
+            std::vector<std::size_t> ring_ends;
+
+            // holes completely on the kept side and the built outer
+            // ring they are in
+            std::vector<std::size_t> holes;
+            std::vector<std::size_t> hole_owners;
+        };
+
+        /**
+         * Signed area of a closed ring, positive if counterclockwise.
+         */
+        inline double signed_area(const double* coords, const std::size_t n, const std::size_t stride) noexcept {
+            double sum = 0.0;
+            for (std::size_t i = 1; i + 1 < n; ++i) {
+                const double* a = coords + i * stride;
+                const double* b = a + stride;
+                sum += (a[0] - coords[0]) * (b[1] - coords[1]) - (b[0] - coords[0]) * (a[1] - coords[1]);
+            }
+            return sum / 2;
+        }
+
+        inline void reverse_points(double* coords, const std::size_t n, const std::size_t stride) noexcept {
+            for (std::size_t i = 0, j = n - 1; i < j; ++i, --j) {
+                std::swap_ranges(coords + i * stride, coords + (i + 1) * stride, coords + j * stride);
+            }
+        }
+
+        /**
+         * Orient outer rings counterclockwise and inner rings clockwise
+         * as clip_half_plane() needs them.
+         */
+        inline void orient_rings(polygon_list& polygons, const std::size_t stride) noexcept {
+            for (std::size_t p = 0; p < polygons.polygon_ends.size(); ++p) {
+                for (std::size_t r = polygons.polygon_begin(p); r < polygons.polygon_ends[p]; ++r) {
+                    double* ring = polygons.coords.data() + polygons.ring_begin(r) * stride;
+                    const std::size_t n = polygons.ring_ends[r] - polygons.ring_begin(r);
+                    const double area = signed_area(ring, n, stride);
+                    const bool outer = r == polygons.polygon_begin(p);
+                    if ((outer && area < 0.0) || (!outer && area > 0.0)) {
+                        reverse_points(ring, n, stride);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Is the point (x, y) inside the closed ring? Even-odd rule.
+         */
+        inline bool point_in_ring(const double x, const double y, const double* coords, const std::size_t n,
+                                  const std::size_t stride) noexcept {
+            bool inside = false;
+            for (std::size_t i = 1; i < n; ++i) {
+                const double* a = coords + (i - 1) * stride;
+                const double* b = a + stride;
+                if ((a[1] > y) != (b[1] > y) &&
+                    x < a[0] + (y - a[1]) * (b[0] - a[0]) / (b[1] - a[1])) {
+                    inside = !inside;
+                }
+            }
+            return inside;
+        }
+
+        /**
+         * Append the point p to out unless it repeats the last point of
+         * the ring starting at point first.
+         */
+        inline void push_distinct(std::vector<double>& out, const double* p, const std::size_t stride,
+                                  const std::size_t first) {
+            const std::size_t size = out.size();
+            if (size > first * stride && std::equal(p, p + stride, out.data() + size - stride)) {
+                return;
+            }
+            out.insert(out.end(), p, p + stride);
+        }
+
+        /**
+         * Close the ring starting at point first in out and record its
+         * end. Rings with less than 4 points are removed.
+         */
+        inline void close_ring(std::vector<double>& out, std::vector<std::size_t>& ends, const std::size_t stride,
+                               const std::size_t first) {
+            std::vector<double>::size_type start = first * stride;
+            if (out.size() > start + stride &&
+                !std::equal(out.data() + start, out.data() + start + stride, out.data() + out.size() - stride)) {
+                out.insert(out.end(), out.begin() + start, out.begin() + start + stride);
+            }
+            if (out.size() < start + 4 * stride) {
+                out.resize(start);
+                return;
+            }
+            ends.push_back(out.size() / stride);
+        }
+
+        /**
+         * Split the ring (n points, closed) into the chains on the kept
+         * side of the line. Points on the line count as kept. At least one
+         * point must be on each side. Chains only touching the line are
+         * dropped.
+         */
+        inline void ring_chains(const double* ring, const std::size_t n, const std::size_t stride, const std::size_t axis,
+                                const double c, const bool below, half_plane_scratch& scratch) {
+            const std::size_t other = 1 - axis;
+            const std::size_t m = n - 1;
+            std::vector<double>& out = scratch.chain_coords;
+            auto inside = [&](const double* p) {
+                return below ? p[axis] <= c : p[axis] >= c;
+            };
+            ring_chain current{0, 0, 0.0, 0.0};
+            auto push_crossing = [&](const double* a, const double* b) {
+                push_between(out, a, b, (c - a[axis]) / (b[axis] - a[axis]), stride);
+                const std::size_t last = out.size() - stride;
+                out[last + axis] = c;
+                // a point on the line is the crossing itself
+                if (last >= (current.begin + 1) * stride &&
+                    std::equal(out.data() + last, out.data() + out.size(), out.data() + last - stride)) {
+                    out.resize(last);
+                }
+                return out[out.size() - stride + other];
+            };
+            auto on_line = [&]() {
+                for (std::size_t p = current.begin; p < current.end; ++p) {
+                    if (out[p * stride + axis] != c) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            std::size_t start = 0;
+            while (inside(ring + start * stride)) {
+                ++start;
+            }
+            for (std::size_t k = 0; k < m; ++k) {
+                const std::size_t i = (start + k) % m;
+                const double* a = ring + i * stride;
+                const double* b = ring + ((i + 1) % m) * stride;
+                const bool in_a = inside(a);
+                const bool in_b = inside(b);
+                if (!in_a && in_b) {
+                    current.begin = out.size() / stride;
+                    current.entry = push_crossing(a, b);
+                }
+                if (in_b) {
+                    push_distinct(out, b, stride, current.begin);
+                } else if (in_a) {
+                    current.exit = push_crossing(a, b);
+                    current.end = out.size() / stride;
+                    if (on_line()) {
+                        out.resize(current.begin * stride);
+                    } else {
+                        scratch.chains.push_back(current);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Connect the chains into closed rings: walking along the line
+         * with the kept side on the left, each exit is followed by the
+         * next entry. If the crossings do not alternate (invalid input),
+         * each chain is closed on its own.
+         */
+        inline void connect_chains(const std::size_t stride, const bool ascending, half_plane_scratch& scratch) {
+            const std::size_t count = scratch.chains.size();
+            scratch.crossings.clear();
+            for (std::size_t i = 0; i < count; ++i) {
+                const ring_chain& chain = scratch.chains[i];
+                scratch.crossings.emplace_back(ascending ? chain.entry : -chain.entry, 2 * i);
+                scratch.crossings.emplace_back(ascending ? chain.exit : -chain.exit, 2 * i + 1);
+            }
+            // at the same position exits come first
+            std::sort(scratch.crossings.begin(), scratch.crossings.end(),
+                      [](const std::pair<double, std::size_t>& lhs, const std::pair<double, std::size_t>& rhs) {
+                          return lhs.first < rhs.first || (lhs.first == rhs.first && (lhs.second & 1u) > (rhs.second & 1u));
+                      });
+
+            scratch.next.resize(count);
+            bool alternating = true;
+            for (std::size_t k = 0; k < scratch.crossings.size(); k += 2) {
+                const std::size_t exit = scratch.crossings[k].second;
+                const std::size_t entry = scratch.crossings[k + 1].second;
+                if ((exit & 1u) == 0 || (entry & 1u) != 0) {
+                    alternating = false;
+                    break;
+                }
+                scratch.next[exit / 2] = entry / 2;
+            }
+            if (!alternating) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    scratch.next[i] = i;
+                }
+            }
+
+            scratch.ring_coords.clear();
+            scratch.ring_ends.clear();
+            scratch.visited.assign(count, 0);
+            for (std::size_t i = 0; i < count; ++i) {
+                if (scratch.visited[i]) {
+                    continue;
+                }
+                const std::size_t first = scratch.ring_coords.size() / stride;
+                std::size_t current = i;
+                do {
+                    scratch.visited[current] = 1;
+                    const ring_chain& chain = scratch.chains[current];
+                    for (std::size_t p = chain.begin; p < chain.end; ++p) {
+                        push_distinct(scratch.ring_coords, scratch.chain_coords.data() + p * stride, stride, first);
+                    }
+                    current = scratch.next[current];
+                } while (!scratch.visited[current]);
+                close_ring(scratch.ring_coords, scratch.ring_ends, stride, first);
+            }
+        }
+
+        /**
+         * Append the part of the polygons in src on one side of the line
+         * coordinate[axis] == c to dst (below: the side with smaller
+         * values). Points on the line are kept. Outer rings must be
+         * counterclockwise and inner rings clockwise; the results are
+         * oriented the same way.
+         *
+         * Rings crossing the line are cut into chains which are connected
+         * along the line (Weiler-Atherton). Inner rings crossing the line
+         * so become part of an outer ring and the results are valid
+         * polygons. Inner rings completely on the kept side are assigned
+         * to the outer ring around them.
+         */
+        inline void clip_half_plane(const polygon_list& src, const std::size_t stride, const std::size_t axis,
+                                    const double c, const bool below, polygon_list& dst, half_plane_scratch& scratch) {
+            auto count_inside = [&](const double* ring, std::size_t m) {
+                std::size_t count = 0;
+                for (std::size_t i = 0; i < m; ++i) {
+                    const double v = ring[i * stride + axis];
+                    count += below ? v <= c : v >= c;
+                }
+                return count;
+            };
+            auto copy_ring = [&](const double* ring, std::size_t n) {
+                dst.coords.insert(dst.coords.end(), ring, ring + n * stride);
+                dst.ring_ends.push_back(dst.coords.size() / stride);
+            };
+
+            dst.clear();
+            for (std::size_t p = 0; p < src.polygon_ends.size(); ++p) {
+                const std::size_t first_ring = src.polygon_begin(p);
+                scratch.chain_coords.clear();
+                scratch.chains.clear();
+                scratch.holes.clear();
+
+                bool outer_inside = false;
+                bool outside = false;
+                for (std::size_t r = first_ring; r < src.polygon_ends[p]; ++r) {
+                    const double* ring = src.coords.data() + src.ring_begin(r) * stride;
+                    const std::size_t n = src.ring_ends[r] - src.ring_begin(r);
+                    const std::size_t inside = count_inside(ring, n - 1);
+                    if (inside == 0) {
+                        if (r == first_ring) {
+                            outside = true;
+                            break;
+                        }
+                    } else if (inside == n - 1) {
+                        if (r == first_ring) {
+                            outer_inside = true;
+                        } else {
+                            scratch.holes.push_back(r);
+                        }
+                    } else {
+                        ring_chains(ring, n, stride, axis, c, below, scratch);
+                    }
+                }
+                if (outside) {
+                    continue;
+                }
+
+                if (outer_inside) {
+                    // inner rings are inside the outer ring, so on this side
+                    copy_ring(src.coords.data() + src.ring_begin(first_ring) * stride,
+                              src.ring_ends[first_ring] - src.ring_begin(first_ring));
+                    for (const std::size_t r : scratch.holes) {
+                        copy_ring(src.coords.data() + src.ring_begin(r) * stride, src.ring_ends[r] - src.ring_begin(r));
+                    }
+                    dst.polygon_ends.push_back(dst.ring_ends.size());
+                    continue;
+                }
+
+                connect_chains(stride, (axis == 0) == below, scratch);
+                const std::size_t outers = scratch.ring_ends.size();
+                scratch.hole_owners.clear();
+                for (const std::size_t r : scratch.holes) {
+                    // a point of the hole not on the line is inside its
+                    // outer ring, not on the boundary
+                    const double* hole = src.coords.data() + src.ring_begin(r) * stride;
+                    const double* hole_end = src.coords.data() + src.ring_ends[r] * stride;
+                    while (hole + stride < hole_end && hole[axis] == c) {
+                        hole += stride;
+                    }
+                    std::size_t owner = 0;
+                    for (std::size_t o = 0; o < outers && outers > 1; ++o) {
+                        const std::size_t begin = o == 0 ? 0 : scratch.ring_ends[o - 1];
+                        if (point_in_ring(hole[0], hole[1], scratch.ring_coords.data() + begin * stride,
+                                          scratch.ring_ends[o] - begin, stride)) {
+                            owner = o;
+                            break;
+                        }
+                    }
+                    scratch.hole_owners.push_back(owner);
+                }
+                for (std::size_t o = 0; o < outers; ++o) {
+                    const std::size_t begin = o == 0 ? 0 : scratch.ring_ends[o - 1];
+                    copy_ring(scratch.ring_coords.data() + begin * stride, scratch.ring_ends[o] - begin);
+                    for (std::size_t h = 0; h < scratch.holes.size(); ++h) {
+                        if (scratch.hole_owners[h] == o) {
+                            const std::size_t r = scratch.holes[h];
+                            copy_ring(src.coords.data() + src.ring_begin(r) * stride, src.ring_ends[r] - src.ring_begin(r));
+                        }
+                    }
+                    dst.polygon_ends.push_back(dst.ring_ends.size());
+                }
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * Clips geometries to an axis-aligned box before writing them with
+     * TWriter. It has the same interface as the writer for
+     * (Multi)LineStrings and (Multi)Polygons.
+     *
+     * The points of each linestring or ring are buffered until it is
+     * finished. If their bounding box is inside the clip box they are
+     * passed to the writer unchanged, if it is outside they are dropped;
+     * only the remaining ones are clipped. Linestrings are clipped with
+     * Liang-Barsky and become MultiLineStrings if they leave and reenter
+     * the box.
+     *
+     * Polygons are buffered with all their rings and cut at each edge of
+     * the box they cross with clip_half_plane(), which connects the parts
+     * of the rings along the edge. Inner rings crossing the box become
+     * part of the outer ring, so the results are valid polygons. Like
+     * linestrings, a polygon becomes a MultiPolygon if it enters the box
+     * several times. The orientation of the outer ring is kept.
+     *
+     * Nothing is written for geometries entirely outside the box. Then
+     * the finish methods return an empty string or false.
+     */
+    template <typename TWriter>
+    class Clipper {
+
+        TWriter& m_writer;
+        box m_box;
+
+        // points of the open linestring or ring
+        std::vector<double> m_points;
+        detail::clip_scratch m_scratch;
+
+        // rings of the open polygon, their points are in m_points
+        detail::polygon_list m_polygon;
+
+        // results of the cuts at the edges of the box, used alternately
+        detail::polygon_list m_pieces[2];
+        detail::half_plane_scratch m_half_plane;
+
+        // the multi geometry has been started in the writer
+        bool m_open = false;
+
+        void add(const double* coords, const std::size_t n) {
+            if (n != m_writer.format().stride()) {
+                throw wkb_error{"Number of coordinates does not match the dimensions of the writer"};
+            }
+            m_points.insert(m_points.end(), coords, coords + n);
+        }
+
+        void add_bulk(const double* coords, const std::size_t n) {
+            m_points.insert(m_points.end(), coords, coords + n * m_writer.format().stride());
+        }
+
+        std::size_t num_points() const noexcept {
+            return m_points.size() / m_writer.format().stride();
+        }
+
+        box points_box() const noexcept {
+            box result;
+            detail::extend_box(result, m_points.data(), num_points(), m_writer.format().stride());
+            return result;
+        }
+
+        /**
+         * Clip the buffered linestring.
+         *
+         * @returns the number of pieces; their points start at first and
+         *          piece i ends at point m_scratch.ends[i]
+         */
+        std::size_t clip_linestring(const double*& first) {
+            const std::size_t n = num_points();
+            m_scratch.ends.clear();
+            first = m_points.data();
+            if (n < 2) {
+                return 0;
+            }
+            switch (detail::relate(m_box, points_box())) {
+                case detail::box_relation::disjoint:
+                    return 0;
+                case detail::box_relation::inside:
+                    m_scratch.ends.push_back(n);
+                    return 1;
+                default:
+                    detail::clip_linestring(m_points.data(), n, m_writer.format().stride(), m_box, m_scratch);
+                    first = m_scratch.out.data();
+                    return m_scratch.ends.size();
+            }
+        }
+
+        /**
+         * Record the end of the buffered ring. Rings with less than 4
+         * points are dropped, and so are inner rings without an outer
+         * ring.
+         */
+        void finish_ring(const bool outer) {
+            const std::size_t begin = m_polygon.ring_ends.empty() ? 0 : m_polygon.ring_ends.back();
+            if (num_points() < begin + 4 || outer != m_polygon.ring_ends.empty()) {
+                m_points.resize(begin * m_writer.format().stride());
+                return;
+            }
+            m_polygon.ring_ends.push_back(num_points());
+        }
+
+        void start_polygon() {
+            m_points.clear();
+            m_polygon.clear();
+        }
+
+        /**
+         * Clip the buffered polygon.
+         *
+         * @returns the pieces inside the box, nullptr if there are none
+         */
+        const detail::polygon_list* clip_polygon() {
+            const std::size_t stride = m_writer.format().stride();
+            // swap to keep the capacity of both buffers
+            m_polygon.coords.swap(m_points);
+            if (m_polygon.ring_ends.empty()) {
+                return nullptr;
+            }
+            m_polygon.polygon_ends.assign(1, m_polygon.ring_ends.size());
+            const std::size_t outer = m_polygon.ring_ends.front();
+            box bounds;
+            detail::extend_box(bounds, m_polygon.coords.data(), outer, stride);
+            switch (detail::relate(m_box, bounds)) {
+                case detail::box_relation::disjoint:
+                    return nullptr;
+                case detail::box_relation::inside:
+                    return &m_polygon;
+                default:
+                    break;
+            }
+
+            const bool clockwise = detail::signed_area(m_polygon.coords.data(), outer, stride) < 0.0;
+            detail::orient_rings(m_polygon, stride);
+            const double bound[4] = {m_box.min_x, m_box.max_x, m_box.min_y, m_box.max_y};
+            const bool crossed[4] = {bounds.min_x < m_box.min_x, bounds.max_x > m_box.max_x,
+                                     bounds.min_y < m_box.min_y, bounds.max_y > m_box.max_y};
+            detail::polygon_list* pieces = &m_polygon;
+            for (std::size_t k = 0; k < 4; ++k) {
+                if (crossed[k]) {
+                    detail::polygon_list& dst = m_pieces[pieces == &m_pieces[0] ? 1 : 0];
+                    detail::clip_half_plane(*pieces, stride, k / 2, bound[k], k % 2 == 1, dst, m_half_plane);
+                    pieces = &dst;
+                }
+            }
+            if (pieces->polygon_ends.empty()) {
+                return nullptr;
+            }
+            if (clockwise) {
+                for (std::size_t r = 0; r < pieces->ring_ends.size(); ++r) {
+                    const std::size_t begin = pieces->ring_begin(r);
+                    detail::reverse_points(pieces->coords.data() + begin * stride, pieces->ring_ends[r] - begin, stride);
+                }
+            }
+            return pieces;
+        }
+
+        void write_polygon(const detail::polygon_list& pieces, const std::size_t p) {
+            const std::size_t stride = m_writer.format().stride();
+            m_writer.polygon_start();
+            for (std::size_t r = pieces.polygon_begin(p); r < pieces.polygon_ends[p]; ++r) {
+                const std::size_t begin = pieces.ring_begin(r);
+                if (r == pieces.polygon_begin(p)) {
+                    m_writer.polygon_outer_ring_start();
+                    m_writer.polygon_add_locations(pieces.coords.data() + begin * stride, pieces.ring_ends[r] - begin);
+                    m_writer.polygon_outer_ring_finish();
+                } else {
+                    m_writer.polygon_inner_ring_start();
+                    m_writer.polygon_add_locations(pieces.coords.data() + begin * stride, pieces.ring_ends[r] - begin);
+                    m_writer.polygon_inner_ring_finish();
+                }
+            }
+        }
+
+        void write_members(const detail::polygon_list& pieces) {
+            const std::size_t stride = m_writer.format().stride();
+            if (!m_open) {
+                m_writer.multipolygon_start();
+                m_open = true;
+            }
+            for (std::size_t p = 0; p < pieces.polygon_ends.size(); ++p) {
+                m_writer.multipolygon_polygon_start();
+                for (std::size_t r = pieces.polygon_begin(p); r < pieces.polygon_ends[p]; ++r) {
+                    const std::size_t begin = pieces.ring_begin(r);
+                    if (r == pieces.polygon_begin(p)) {
+                        m_writer.multipolygon_outer_ring_start();
+                        m_writer.multipolygon_add_locations(pieces.coords.data() + begin * stride, pieces.ring_ends[r] - begin);
+                        m_writer.multipolygon_outer_ring_finish();
+                    } else {
+                        m_writer.multipolygon_inner_ring_start();
+                        m_writer.multipolygon_add_locations(pieces.coords.data() + begin * stride, pieces.ring_ends[r] - begin);
+                        m_writer.multipolygon_inner_ring_finish();
+                    }
+                }
+                m_writer.multipolygon_polygon_finish();
+            }
+        }
+
+        void write_pieces(const double* first) {
+            const std::size_t stride = m_writer.format().stride();
+            std::size_t begin = 0;
+            for (const std::size_t end : m_scratch.ends) {
+                if (!m_open) {
+                    m_writer.multilinestring_start();
+                    m_open = true;
+                }
+                m_writer.multilinestring_linestring_start();
+                m_writer.multilinestring_add_locations(first + begin * stride, end - begin);
+                m_writer.multilinestring_linestring_finish();
+                begin = end;
+            }
+        }
+
+    public:
+
+        Clipper(TWriter& writer, const box& clip_box) :
+            m_writer(writer),
+            m_box(clip_box) {
+        }
+
+        TWriter& writer() noexcept {
+            return m_writer;
+        }
+
+        const box& clip_box() const noexcept {
+            return m_box;
+        }
+
+        void set_clip_box(const box& clip_box) noexcept {
+            m_box = clip_box;
+        }
+
+        /* LineString */
+
+        void linestring_start() {
+            m_points.clear();
+        }
+
+        /**
+         * Add a point of the linestring. Like with the writer, the number
+         * of coordinates must match its dimensions. This holds for all
+         * add_location methods.
+         */
+        void linestring_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void linestring_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void linestring_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        /**
+         * Add n points given as interleaved coordinates, see
+         * GenericWKBWriter::linestring_add_locations(). This holds for
+         * all add_locations methods.
+         */
+        void linestring_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        /**
+         * Write the clipped linestring: a LineString if one piece is
+         * inside the box, a MultiLineString if there are several.
+         *
+         * @returns an empty string if the linestring is outside the box
+         */
+        std::string linestring_finish() {
+            std::string out;
+            linestring_finish(out);
+            return out;
+        }
+
+        /**
+         * Append the clipped linestring to out.
+         *
+         * @returns false if the linestring is outside the box
+         */
+        bool linestring_finish(std::string& out) {
+            const double* first;
+            const std::size_t pieces = clip_linestring(first);
+            m_points.clear();
+            if (pieces == 0) {
+                return false;
+            }
+            if (pieces == 1) {
+                const std::size_t count = m_scratch.ends.front();
+                m_writer.linestring_start();
+                m_writer.linestring_add_locations(first, count);
+                m_writer.linestring_finish(count, out);
+                return true;
+            }
+            m_open = false;
+            write_pieces(first);
+            m_open = false;
+            m_writer.multilinestring_finish(out);
+            return true;
+        }
+
+        /* Polygon */
+
+        void polygon_start() {
+            start_polygon();
+        }
+
+        void polygon_outer_ring_start() {
+        }
+
+        void polygon_outer_ring_finish() {
+            finish_ring(true);
+        }
+
+        void polygon_inner_ring_start() {
+        }
+
+        void polygon_inner_ring_finish() {
+            finish_ring(false);
+        }
+
+        void polygon_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void polygon_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void polygon_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        void polygon_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        /**
+         * Write the clipped polygon: a Polygon if one piece is inside the
+         * box, a MultiPolygon if there are several.
+         *
+         * @returns an empty string if the outer ring is outside the box
+         */
+        std::string polygon_finish() {
+            std::string out;
+            polygon_finish(out);
+            return out;
+        }
+
+        /**
+         * @returns false if the outer ring is outside the box
+         */
+        bool polygon_finish(std::string& out) {
+            const detail::polygon_list* pieces = clip_polygon();
+            if (pieces == nullptr) {
+                return false;
+            }
+            if (pieces->polygon_ends.size() == 1) {
+                write_polygon(*pieces, 0);
+                m_writer.polygon_finish(out);
+                return true;
+            }
+            m_open = false;
+            write_members(*pieces);
+            m_open = false;
+            m_writer.multipolygon_finish(out);
+            return true;
+        }
+
+        /* MultiLineString */
+
+        void multilinestring_start() {
+            m_open = false;
+        }
+
+        void multilinestring_linestring_start() {
+            m_points.clear();
+        }
+
+        void multilinestring_linestring_finish() {
+            const double* first;
+            clip_linestring(first);
+            write_pieces(first);
+            m_points.clear();
+        }
+
+        void multilinestring_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void multilinestring_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void multilinestring_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        void multilinestring_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        /**
+         * @returns an empty string if all linestrings are outside the box
+         */
+        std::string multilinestring_finish() {
+            std::string out;
+            multilinestring_finish(out);
+            return out;
+        }
+
+        /**
+         * @returns false if all linestrings are outside the box
+         */
+        bool multilinestring_finish(std::string& out) {
+            if (!m_open) {
+                return false;
+            }
+            m_open = false;
+            m_writer.multilinestring_finish(out);
+            return true;
+        }
+
+        /* MultiPolygon */
+
+        void multipolygon_start() {
+            m_open = false;
+        }
+
+        void multipolygon_polygon_start() {
+            start_polygon();
+        }
+
+        void multipolygon_polygon_finish() {
+            const detail::polygon_list* pieces = clip_polygon();
+            if (pieces != nullptr) {
+                write_members(*pieces);
+            }
+        }
+
+        void multipolygon_outer_ring_start() {
+        }
+
+        void multipolygon_outer_ring_finish() {
+            finish_ring(true);
+        }
+
+        void multipolygon_inner_ring_start() {
+        }
+
+        void multipolygon_inner_ring_finish() {
+            finish_ring(false);
+        }
+
+        void multipolygon_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void multipolygon_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void multipolygon_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        void multipolygon_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        /**
+         * @returns an empty string if all polygons are outside the box
+         */
+        std::string multipolygon_finish() {
+            std::string out;
+            multipolygon_finish(out);
+            return out;
+        }
+
+        /**
+         * @returns false if all polygons are outside the box
+         */
+        bool multipolygon_finish(std::string& out) {
+            if (!m_open) {
+                return false;
+            }
+            m_open = false;
+            m_writer.multipolygon_finish(out);
+            return true;
+        }
+
+    }; // class Clipper
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_CLIP_HPP */
@@ -0,0 +1,107 @@
+#ifndef WKBHPP_DETAIL_COORDINATES_HPP
+#define WKBHPP_DETAIL_COORDINATES_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/detail/cpu.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+namespace wkbhpp {
+
+    namespace detail {
+
+        /**
+         * Write n points given as separate arrays of x and y coordinates
+         * as interleaved x/y pairs to out. out does not need to be aligned.
+         */
+        inline void interleave_xy(char* out, const double* x, const double* y, std::size_t n) noexcept {
+            std::size_t i = 0;
+#if WKBHPP_HAS_SSE2
+            for (; i + 2 <= n; i += 2) {
+                const __m128d xs = _mm_loadu_pd(x + i);
+                const __m128d ys = _mm_loadu_pd(y + i);
+                _mm_storeu_pd(reinterpret_cast<double*>(out), _mm_unpacklo_pd(xs, ys));
+                _mm_storeu_pd(reinterpret_cast<double*>(out + 2 * sizeof(double)), _mm_unpackhi_pd(xs, ys));
+                out += 4 * sizeof(double);
+            }
+#endif
+            for (; i < n; ++i) {
+                std::memcpy(out, x + i, sizeof(double));
+                std::memcpy(out + sizeof(double), y + i, sizeof(double));
+                out += 2 * sizeof(double);
+            }
+        }
+
+        /**
+         * Reverse the order of count records of size bytes each in place.
+         * Records of a multiple of 16 bytes (at most 64) are swapped in 16
+         * byte blocks.
+         */
+        inline void reverse_records(char* data, std::size_t count, std::size_t size) noexcept {
+            if (count < 2) {
+                return;
+            }
+            char* front = data;
+            char* back = data + (count - 1) * size;
+#if WKBHPP_HAS_SSE2
+            if (size % 16 == 0 && size <= 64) {
+                for (; front < back; front += size, back -= size) {
+                    for (std::size_t i = 0; i < size; i += 16) {
+                        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(front + i));
+                        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(back + i));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(front + i), b);
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(back + i), a);
+                    }
+                }
+                return;
+            }
+#endif
+            char tmp[64];
+            for (; front < back; front += size, back -= size) {
+                for (std::size_t i = 0; i < size; i += sizeof(tmp)) {
+                    const std::size_t chunk = size - i < sizeof(tmp) ? size - i : sizeof(tmp);
+                    std::memcpy(tmp, front + i, chunk);
+                    std::memcpy(front + i, back + i, chunk);
+                    std::memcpy(back + i, tmp, chunk);
+                }
+            }
+        }
+
+    } // namespace detail
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_DETAIL_COORDINATES_HPP */
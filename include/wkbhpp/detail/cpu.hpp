@@ -0,0 +1,149 @@
+#ifndef WKBHPP_DETAIL_CPU_HPP
+#define WKBHPP_DETAIL_CPU_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <cstdint>
+
+#if defined(WKBHPP_NO_SIMD)
+# define WKBHPP_SIMD_X86 0
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+# define WKBHPP_SIMD_X86 1
+# include <cpuid.h>
+# include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# define WKBHPP_SIMD_X86 1
+# include <intrin.h>
+# include <immintrin.h>
+#else
+# define WKBHPP_SIMD_X86 0
+#endif
+
+// SSE2 is part of the baseline of the target, so it can be used without a
+// runtime check. Disabled together with the rest by WKBHPP_NO_SIMD.
+#if WKBHPP_SIMD_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+# define WKBHPP_HAS_SSE2 1
+# include <emmintrin.h>
+#else
+# define WKBHPP_HAS_SSE2 0
+#endif
+
+// Functions using instructions beyond the baseline of the target are marked
+// with WKBHPP_TARGET so that they can be compiled without -m flags and are
+// only called after a runtime check.
+#if WKBHPP_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+# define WKBHPP_TARGET(isa) __attribute__((target(isa)))
+#else
+# define WKBHPP_TARGET(isa)
+#endif
+
+namespace wkbhpp {
+
+    namespace detail {
+
+        /**
+         * Instruction set extensions which are used by SIMD code paths.
+         * Later entries imply the earlier ones.
+         */
+        enum class simd_level : uint8_t {
+            scalar = 0,
+            sse2   = 1,
+            ssse3  = 2,
+            avx2   = 3
+        }; // enum class simd_level
+
+        inline simd_level detect_simd_level() noexcept {
+#if WKBHPP_SIMD_X86
+            unsigned int regs[4] = {0, 0, 0, 0};
+# if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            const unsigned int max_leaf = static_cast<unsigned int>(info[0]);
+            __cpuid(info, 1);
+            for (int i = 0; i < 4; ++i) {
+                regs[i] = static_cast<unsigned int>(info[i]);
+            }
+# else
+            const unsigned int max_leaf = __get_cpuid_max(0, nullptr);
+            __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+# endif
+            const bool sse2 = (regs[3] & (1u << 26u)) != 0;
+            const bool ssse3 = (regs[2] & (1u << 9u)) != 0;
+            const bool osxsave = (regs[2] & (1u << 27u)) != 0;
+            const bool avx = (regs[2] & (1u << 28u)) != 0;
+
+            if (!sse2) {
+                return simd_level::scalar;
+            }
+            if (!ssse3) {
+                return simd_level::sse2;
+            }
+
+            bool avx2 = false;
+            if (max_leaf >= 7 && osxsave && avx) {
+                // The operating system must save the YMM registers.
+# if defined(_MSC_VER)
+                const uint64_t xcr0 = _xgetbv(0);
+                __cpuidex(info, 7, 0);
+                regs[1] = static_cast<unsigned int>(info[1]);
+# else
+                unsigned int xcr0_lo = 0;
+                unsigned int xcr0_hi = 0;
+                __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+                const uint64_t xcr0 = (static_cast<uint64_t>(xcr0_hi) << 32u) | xcr0_lo;
+                __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+# endif
+                avx2 = (xcr0 & 0x6u) == 0x6u && (regs[1] & (1u << 5u)) != 0;
+            }
+
+            return avx2 ? simd_level::avx2 : simd_level::ssse3;
+#else
+            return simd_level::scalar;
+#endif
+        }
+
+        /**
+         * The SIMD level supported by the CPU the program is running on.
+         * Detected once on first use.
+         */
+        inline simd_level cpu_simd_level() noexcept {
+            static const simd_level level = detect_simd_level();
+            return level;
+        }
+
+    } // namespace detail
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_DETAIL_CPU_HPP */
@@ -0,0 +1,213 @@
+#ifndef WKBHPP_DETAIL_ENDIAN_HPP
+#define WKBHPP_DETAIL_ENDIAN_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+// macros for endianess (taken from Libosmium)
+// Windows is only available for little endian architectures
+// http://stackoverflow.com/questions/6449468/can-i-safely-assume-that-windows-installations-will-always-be-little-endian
+#if defined(__FreeBSD__)
+# include <sys/endian.h>
+#elif !defined(_WIN32) && !defined(__APPLE__)
+# include <endian.h>
+#else
+# define __LITTLE_ENDIAN 1234
+# define __BYTE_ORDER __LITTLE_ENDIAN
+#endif
+
+#include <wkbhpp/detail/cpu.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace wkbhpp {
+
+    namespace detail {
+
+        inline uint8_t byte_swap(uint8_t value) noexcept {
+            return value;
+        }
+
+        inline uint32_t byte_swap(uint32_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_bswap32(value);
+#else
+            return ((value & 0x000000ffu) << 24u) |
+                   ((value & 0x0000ff00u) <<  8u) |
+                   ((value & 0x00ff0000u) >>  8u) |
+                   ((value & 0xff000000u) >> 24u);
+#endif
+        }
+
+        inline uint64_t byte_swap(uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_bswap64(value);
+#else
+            return (static_cast<uint64_t>(byte_swap(static_cast<uint32_t>(value))) << 32u) |
+                    byte_swap(static_cast<uint32_t>(value >> 32u));
+#endif
+        }
+
+        template <std::size_t N>
+        struct unsigned_of_size;
+
+        template <>
+        struct unsigned_of_size<1> {
+            using type = uint8_t;
+        };
+
+        template <>
+        struct unsigned_of_size<4> {
+            using type = uint32_t;
+        };
+
+        template <>
+        struct unsigned_of_size<8> {
+            using type = uint64_t;
+        };
+
+        /**
+         * Reverse the bytes of a value of 1, 4 or 8 bytes (integers, enums
+         * and doubles).
+         */
+        template <typename T>
+        inline T byte_swap_value(T value) noexcept {
+            typename unsigned_of_size<sizeof(T)>::type bits;
+            std::memcpy(&bits, &value, sizeof(T));
+            bits = byte_swap(bits);
+            std::memcpy(&value, &bits, sizeof(T));
+            return value;
+        }
+
+        // implementations of byte_swap_doubles() for different SIMD levels
+        using byte_swap_func = void (*)(char*, const char*, std::size_t);
+
+        inline void byte_swap_doubles_scalar(char* out, const char* in, std::size_t n) noexcept {
+            for (std::size_t i = 0; i < n; ++i) {
+                uint64_t bits;
+                std::memcpy(&bits, in + i * sizeof(uint64_t), sizeof(uint64_t));
+                bits = byte_swap(bits);
+                std::memcpy(out + i * sizeof(uint64_t), &bits, sizeof(uint64_t));
+            }
+        }
+
+#if WKBHPP_SIMD_X86
+
+        WKBHPP_TARGET("sse2")
+        inline void byte_swap_doubles_sse2(char* out, const char* in, std::size_t n) noexcept {
+            std::size_t i = 0;
+            for (; i + 2 <= n; i += 2) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * sizeof(uint64_t)));
+                // swap the bytes in each 16 bit word, then reverse the words
+                v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * sizeof(uint64_t)), v);
+            }
+            byte_swap_doubles_scalar(out + i * sizeof(uint64_t), in + i * sizeof(uint64_t), n - i);
+        }
+
+        WKBHPP_TARGET("ssse3")
+        inline void byte_swap_doubles_ssse3(char* out, const char* in, std::size_t n) noexcept {
+            const __m128i shuffle = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+            std::size_t i = 0;
+            for (; i + 2 <= n; i += 2) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * sizeof(uint64_t)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * sizeof(uint64_t)), _mm_shuffle_epi8(v, shuffle));
+            }
+            byte_swap_doubles_scalar(out + i * sizeof(uint64_t), in + i * sizeof(uint64_t), n - i);
+        }
+
+        WKBHPP_TARGET("avx2")
+        inline void byte_swap_doubles_avx2(char* out, const char* in, std::size_t n) noexcept {
+            const __m256i shuffle = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                                     7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i * sizeof(uint64_t)));
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + (i + 4) * sizeof(uint64_t)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * sizeof(uint64_t)), _mm256_shuffle_epi8(a, shuffle));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + (i + 4) * sizeof(uint64_t)), _mm256_shuffle_epi8(b, shuffle));
+            }
+            byte_swap_doubles_ssse3(out + i * sizeof(uint64_t), in + i * sizeof(uint64_t), n - i);
+        }
+
+#endif
+
+        /**
+         * Get the byte swapping function for the given SIMD level, see
+         * hex_encoder().
+         */
+        inline byte_swap_func byte_swapper(simd_level level) noexcept {
+#if WKBHPP_SIMD_X86
+            switch (level) {
+                case simd_level::avx2:
+                    return byte_swap_doubles_avx2;
+                case simd_level::ssse3:
+                    return byte_swap_doubles_ssse3;
+                case simd_level::sse2:
+                    return byte_swap_doubles_sse2;
+                default:
+                    break;
+            }
+#else
+            (void)level;
+#endif
+            return byte_swap_doubles_scalar;
+        }
+
+        inline byte_swap_func best_byte_swapper() noexcept {
+            static const byte_swap_func func = byte_swapper(cpu_simd_level());
+            return func;
+        }
+
+        /**
+         * Copy n 8 byte values from in to out reversing the bytes of each
+         * of them. in and out may be the same. Runs of more than a few
+         * values are swapped with the best SIMD implementation for the CPU.
+         */
+        inline void byte_swap_doubles(char* out, const char* in, std::size_t n) noexcept {
+            if (n < 8) {
+                byte_swap_doubles_scalar(out, in, n);
+                return;
+            }
+            best_byte_swapper()(out, in, n);
+        }
+
+    } // namespace detail
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_DETAIL_ENDIAN_HPP */
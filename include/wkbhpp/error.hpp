@@ -0,0 +1,79 @@
+#ifndef WKBHPP_ERROR_HPP
+#define WKBHPP_ERROR_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace wkbhpp {
+
+    class wkb_error : public std::runtime_error {
+
+    public:
+
+        explicit wkb_error(const std::string& message) :
+            std::runtime_error(message) {
+        }
+
+    }; // class geometry_error
+
+    /**
+     * Thrown when decoding invalid HEX input.
+     */
+    class hex_error : public wkb_error {
+
+        std::size_t m_position;
+
+    public:
+
+        hex_error(const std::string& message, std::size_t position) :
+            wkb_error(message),
+            m_position(position) {
+        }
+
+        /**
+         * Offset of the first invalid character in the input. For input of
+         * odd length, this is the offset of the last character.
+         */
+        std::size_t position() const noexcept {
+            return m_position;
+        }
+
+    }; // class hex_error
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_ERROR_HPP */
@@ -0,0 +1,216 @@
+#ifndef WKBHPP_FORMAT_HPP
+#define WKBHPP_FORMAT_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/detail/endian.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wkbhpp {
+
+    enum class wkb_type : bool {
+        wkb  = false,
+        ewkb = true
+    }; // enum class wkb_type
+
+    enum class out_type : bool {
+        binary = false,
+        hex    = true
+    }; // enum class out_type
+
+    /**
+     * Byte order of the output. The values are the byte order markers
+     * used in WKB.
+     */
+    enum class byte_order : uint8_t {
+        xdr = 0, // Big Endian
+        ndr = 1  // Little Endian
+    }; // enum class byte_order
+
+    /**
+     * Coordinates of each point. Bit 0 is set if there is a Z coordinate,
+     * bit 1 if there is an M value.
+     *
+     * Plain WKB marks them with the ISO type codes (1000 + type for Z, 2000
+     * + type for M, 3000 + type for ZM), EWKB with the flags 0x80000000
+     * (Z) and 0x40000000 (M) in the type field.
+     */
+    enum class dimensions : uint8_t {
+        xy   = 0,
+        xyz  = 1,
+        xym  = 2,
+        xyzm = 3
+    }; // enum class dimensions
+
+    constexpr bool has_z(dimensions dims) noexcept {
+        return (static_cast<uint8_t>(dims) & 1u) != 0;
+    }
+
+    constexpr bool has_m(dimensions dims) noexcept {
+        return (static_cast<uint8_t>(dims) & 2u) != 0;
+    }
+
+    /**
+     * Number of doubles per point.
+     */
+    constexpr std::size_t stride(dimensions dims) noexcept {
+        return 2 + (has_z(dims) ? 1 : 0) + (has_m(dims) ? 1 : 0);
+    }
+
+    /**
+     * Winding order of polygon rings in the output. GeoJSON (RFC 7946)
+     * wants counterclockwise outer and clockwise inner rings, shapefiles
+     * the opposite. any keeps the rings as they were added.
+     */
+    enum class ring_orientation : uint8_t {
+        any = 0,
+        ccw = 1,
+        cw  = 2
+    }; // enum class ring_orientation
+
+    /**
+     * Maximum depth of nested multi geometries and GeometryCollections.
+     */
+    constexpr const std::size_t max_collection_depth = 32;
+
+    /**
+     * Type of a WKB geometry as encoded in the lower bits of the type
+     * field, without Z/M and SRID flags.
+     */
+    enum class geometry_type : uint32_t {
+        point               = 1,
+        linestring          = 2,
+        polygon             = 3,
+        multipoint          = 4,
+        multilinestring     = 5,
+        multipolygon        = 6,
+        geometrycollection  = 7
+    }; // enum class geometry_type
+
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+    constexpr const byte_order native_byte_order = byte_order::ndr;
+#else
+    constexpr const byte_order native_byte_order = byte_order::xdr;
+#endif
+
+    /**
+     * Output format fixed at compile time. Used by BasicWKBWriter, all
+     * checks of the format are resolved by the compiler.
+     */
+    template <wkb_type TWkbType, out_type TOutType, byte_order TByteOrder = native_byte_order,
+              dimensions TDimensions = dimensions::xy>
+    struct static_format {
+
+        static constexpr wkb_type wtype() noexcept {
+            return TWkbType;
+        }
+
+        static constexpr out_type otype() noexcept {
+            return TOutType;
+        }
+
+        static constexpr byte_order order() noexcept {
+            return TByteOrder;
+        }
+
+        static constexpr dimensions dims() noexcept {
+            return TDimensions;
+        }
+
+        /**
+         * Number of doubles per point.
+         */
+        static constexpr std::size_t stride() noexcept {
+            return wkbhpp::stride(TDimensions);
+        }
+
+        /**
+         * Size of a point in this format: byte order marker, type,
+         * optional SRID and the coordinates, twice that for HEX.
+         */
+        static constexpr std::size_t point_size() noexcept {
+            return (TOutType == out_type::hex ? 2 : 1) *
+                   (1 + (TWkbType == wkb_type::ewkb ? 2 : 1) * sizeof(uint32_t) + stride() * sizeof(double));
+        }
+
+    }; // struct static_format
+
+    /**
+     * Output format chosen at runtime. Used by WKBWriter.
+     */
+    class dynamic_format {
+
+        wkb_type m_wkb_type;
+        out_type m_out_type;
+        byte_order m_byte_order;
+        dimensions m_dimensions;
+
+    public:
+
+        constexpr explicit dynamic_format(wkb_type wtype = wkb_type::wkb, out_type otype = out_type::binary,
+                                          byte_order order = native_byte_order,
+                                          dimensions dims = dimensions::xy) noexcept :
+            m_wkb_type(wtype),
+            m_out_type(otype),
+            m_byte_order(order),
+            m_dimensions(dims) {
+        }
+
+        constexpr wkb_type wtype() const noexcept {
+            return m_wkb_type;
+        }
+
+        constexpr out_type otype() const noexcept {
+            return m_out_type;
+        }
+
+        constexpr byte_order order() const noexcept {
+            return m_byte_order;
+        }
+
+        constexpr dimensions dims() const noexcept {
+            return m_dimensions;
+        }
+
+        constexpr std::size_t stride() const noexcept {
+            return wkbhpp::stride(m_dimensions);
+        }
+
+    }; // class dynamic_format
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_FORMAT_HPP */
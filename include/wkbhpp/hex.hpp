@@ -0,0 +1,395 @@
+#ifndef WKBHPP_HEX_HPP
+#define WKBHPP_HEX_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/detail/cpu.hpp>
+#include <wkbhpp/error.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wkbhpp {
+
+    enum class hex_case : bool {
+        upper = false,
+        lower = true
+    }; // enum class hex_case
+
+    namespace detail {
+
+        using hex_encode_func = void (*)(char*, const unsigned char*, std::size_t, hex_case);
+
+        /**
+         * Decode size bytes from 2 * size HEX characters. Returns the
+         * offset of the first invalid character in the input or
+         * hex_input_valid. The output may start at the same address as the
+         * input (in-place decoding).
+         */
+        using hex_decode_func = std::size_t (*)(char*, const unsigned char*, std::size_t);
+
+        constexpr const std::size_t hex_input_valid = static_cast<std::size_t>(-1);
+
+        inline void hex_encode_scalar(char* out, const unsigned char* data, std::size_t size, hex_case hcase) noexcept {
+            const char* lookup_hex = hcase == hex_case::lower ? "0123456789abcdef" : "0123456789ABCDEF";
+
+            for (std::size_t i = 0; i < size; ++i) {
+                const unsigned int c = data[i];
+                *out++ = lookup_hex[(c >> 4u) & 0xfu];
+                *out++ = lookup_hex[ c        & 0xfu];
+            }
+        }
+
+        /**
+         * Value of a HEX digit or -1 if c is no HEX digit.
+         */
+        inline int hex_digit_value(unsigned char c) noexcept {
+            const unsigned int digit = c - static_cast<unsigned int>('0');
+            if (digit < 10u) {
+                return static_cast<int>(digit);
+            }
+            const unsigned int letter = (c | 0x20u) - static_cast<unsigned int>('a');
+            if (letter < 6u) {
+                return static_cast<int>(letter) + 10;
+            }
+            return -1;
+        }
+
+        inline std::size_t hex_decode_scalar(char* out, const unsigned char* in, std::size_t size) noexcept {
+            for (std::size_t i = 0; i < size; ++i) {
+                const int hi = hex_digit_value(in[2 * i]);
+                const int lo = hex_digit_value(in[2 * i + 1]);
+                if ((hi | lo) < 0) {
+                    return hi < 0 ? 2 * i : 2 * i + 1;
+                }
+                out[i] = static_cast<char>((hi << 4) | lo);
+            }
+            return hex_input_valid;
+        }
+
+#if WKBHPP_SIMD_X86
+
+        /**
+         * Convert 16 HEX characters to their nibble values. Bits in *valid
+         * are set for every valid character.
+         */
+        WKBHPP_TARGET("sse2")
+        inline __m128i hex_nibbles_sse2(__m128i c, int* valid) noexcept {
+            const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+            const __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            // unsigned x < n is the same as min(x, n - 1) == x
+            const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+            const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+            *valid = _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter));
+            return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                                _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+        }
+
+        WKBHPP_TARGET("sse2")
+        inline std::size_t hex_decode_sse2(char* out, const unsigned char* in, std::size_t size) noexcept {
+            const __m128i low_nibble = _mm_set1_epi16(0x00f0);
+
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                int valid_a = 0;
+                int valid_b = 0;
+                const __m128i a = hex_nibbles_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)), &valid_a);
+                const __m128i b = hex_nibbles_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 16)), &valid_b);
+                if ((valid_a & valid_b) != 0xffff) {
+                    break;
+                }
+                // each 16 bit word holds the high nibble in its low byte
+                const __m128i bytes_a = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(a, 4), low_nibble), _mm_srli_epi16(a, 8));
+                const __m128i bytes_b = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(b, 4), low_nibble), _mm_srli_epi16(b, 8));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(bytes_a, bytes_b));
+            }
+            const std::size_t result = hex_decode_scalar(out + i, in + 2 * i, size - i);
+            return result == hex_input_valid ? hex_input_valid : 2 * i + result;
+        }
+
+        WKBHPP_TARGET("ssse3")
+        inline std::size_t hex_decode_ssse3(char* out, const unsigned char* in, std::size_t size) noexcept {
+            // multiply the high nibble by 16 and add the low nibble
+            const __m128i weights = _mm_set1_epi16(0x0110);
+
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                int valid_a = 0;
+                int valid_b = 0;
+                const __m128i a = hex_nibbles_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)), &valid_a);
+                const __m128i b = hex_nibbles_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 16)), &valid_b);
+                if ((valid_a & valid_b) != 0xffff) {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                                 _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights)));
+            }
+            const std::size_t result = hex_decode_scalar(out + i, in + 2 * i, size - i);
+            return result == hex_input_valid ? hex_input_valid : 2 * i + result;
+        }
+
+        WKBHPP_TARGET("avx2")
+        inline __m256i hex_nibbles_avx2(__m256i c, int* valid) noexcept {
+            const __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+            const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+            const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+            const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+            *valid = _mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter));
+            return _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+                                   _mm256_and_si256(is_letter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+        }
+
+        WKBHPP_TARGET("avx2")
+        inline std::size_t hex_decode_avx2(char* out, const unsigned char* in, std::size_t size) noexcept {
+            const __m256i weights = _mm256_set1_epi16(0x0110);
+
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                int valid_a = 0;
+                int valid_b = 0;
+                const __m256i a = hex_nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), &valid_a);
+                const __m256i b = hex_nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 32)), &valid_b);
+                if ((valid_a & valid_b) != -1) {
+                    break;
+                }
+                // pack works within the 128 bit lanes, reorder the 64 bit blocks afterwards
+                const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xd8));
+            }
+            const std::size_t result = hex_decode_ssse3(out + i, in + 2 * i, size - i);
+            return result == hex_input_valid ? hex_input_valid : 2 * i + result;
+        }
+
+        /**
+         * Nibble to ASCII without a table lookup: '0' + n, plus the distance
+         * between '9' + 1 and 'A' (or 'a') if n > 9.
+         */
+        WKBHPP_TARGET("sse2")
+        inline void hex_encode_sse2(char* out, const unsigned char* data, std::size_t size, hex_case hcase) noexcept {
+            const __m128i mask = _mm_set1_epi8(0x0f);
+            const __m128i zero = _mm_set1_epi8('0');
+            const __m128i nine = _mm_set1_epi8(9);
+            const __m128i letter = _mm_set1_epi8(hcase == hex_case::lower ? 'a' - '0' - 10 : 'A' - '0' - 10);
+
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+                const __m128i lo = _mm_and_si128(v, mask);
+                __m128i first = _mm_unpacklo_epi8(hi, lo);
+                __m128i second = _mm_unpackhi_epi8(hi, lo);
+                first = _mm_add_epi8(_mm_add_epi8(first, zero), _mm_and_si128(_mm_cmpgt_epi8(first, nine), letter));
+                second = _mm_add_epi8(_mm_add_epi8(second, zero), _mm_and_si128(_mm_cmpgt_epi8(second, nine), letter));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), first);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), second);
+            }
+            hex_encode_scalar(out + 2 * i, data + i, size - i, hcase);
+        }
+
+        WKBHPP_TARGET("ssse3")
+        inline void hex_encode_ssse3(char* out, const unsigned char* data, std::size_t size, hex_case hcase) noexcept {
+            const __m128i mask = _mm_set1_epi8(0x0f);
+            const __m128i table = hcase == hex_case::lower ?
+                _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f') :
+                _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                const __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+                const __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(v, mask));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+            }
+            hex_encode_scalar(out + 2 * i, data + i, size - i, hcase);
+        }
+
+        WKBHPP_TARGET("avx2")
+        inline void hex_encode_avx2(char* out, const unsigned char* data, std::size_t size, hex_case hcase) noexcept {
+            const __m256i mask = _mm256_set1_epi8(0x0f);
+            const __m256i table = hcase == hex_case::lower ?
+                _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                 '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f') :
+                _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F',
+                                 '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                const __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+                const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, mask));
+                // unpack works within the 128 bit lanes, reorder the lanes afterwards
+                const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+                const __m256i b = _mm256_unpackhi_epi8(hi, lo);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+            }
+            hex_encode_ssse3(out + 2 * i, data + i, size - i, hcase);
+        }
+
+#endif
+
+        /**
+         * Get the HEX encoder for the given SIMD level. Levels which are not
+         * compiled in fall back to the best available implementation below.
+         */
+        inline hex_encode_func hex_encoder(simd_level level) noexcept {
+#if WKBHPP_SIMD_X86
+            switch (level) {
+                case simd_level::avx2:
+                    return hex_encode_avx2;
+                case simd_level::ssse3:
+                    return hex_encode_ssse3;
+                case simd_level::sse2:
+                    return hex_encode_sse2;
+                default:
+                    break;
+            }
+#else
+            (void)level;
+#endif
+            return hex_encode_scalar;
+        }
+
+        inline hex_encode_func best_hex_encoder() noexcept {
+            static const hex_encode_func func = hex_encoder(cpu_simd_level());
+            return func;
+        }
+
+        /**
+         * Get the HEX decoder for the given SIMD level, see hex_encoder().
+         */
+        inline hex_decode_func hex_decoder(simd_level level) noexcept {
+#if WKBHPP_SIMD_X86
+            switch (level) {
+                case simd_level::avx2:
+                    return hex_decode_avx2;
+                case simd_level::ssse3:
+                    return hex_decode_ssse3;
+                case simd_level::sse2:
+                    return hex_decode_sse2;
+                default:
+                    break;
+            }
+#else
+            (void)level;
+#endif
+            return hex_decode_scalar;
+        }
+
+        inline hex_decode_func best_hex_decoder() noexcept {
+            static const hex_decode_func func = hex_decoder(cpu_simd_level());
+            return func;
+        }
+
+    } // namespace detail
+
+    /**
+     * Write the HEX representation of size bytes starting at data to out.
+     * out must have room for 2 * size characters.
+     *
+     * Inputs of 16 bytes and more use the fastest SIMD implementation
+     * supported by the CPU.
+     */
+    inline void write_hex(char* out, const char* data, std::size_t size, hex_case hcase = hex_case::upper) noexcept {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+        if (size < 16) {
+            detail::hex_encode_scalar(out, bytes, size, hcase);
+        } else {
+            detail::best_hex_encoder()(out, bytes, size, hcase);
+        }
+    }
+
+    /**
+     * Append the HEX representation of a binary string to out.
+     */
+    inline void append_hex(std::string& out, const std::string& str, hex_case hcase = hex_case::upper) {
+        const std::size_t old_size = out.size();
+        out.resize(old_size + str.size() * 2);
+        write_hex(&out[old_size], str.data(), str.size(), hcase);
+    }
+
+    inline std::string convert_to_hex(const std::string& str, hex_case hcase = hex_case::upper) {
+        std::string out;
+        append_hex(out, str, hcase);
+        return out;
+    }
+
+    /**
+     * Decode size HEX characters (upper or lower case) starting at data and
+     * write size / 2 bytes to out. out may point to data to decode in place.
+     *
+     * @throws hex_error if size is odd or the input contains a character
+     *         which is not a HEX digit. The output is undefined in this case.
+     */
+    inline void read_hex(char* out, const char* data, std::size_t size) {
+        if (size % 2 != 0) {
+            throw hex_error{"HEX input has odd length", size - 1};
+        }
+        const auto* chars = reinterpret_cast<const unsigned char*>(data);
+        const std::size_t invalid = size < 32 ?
+            detail::hex_decode_scalar(out, chars, size / 2) :
+            detail::best_hex_decoder()(out, chars, size / 2);
+        if (invalid != detail::hex_input_valid) {
+            throw hex_error{"Invalid character in HEX input at offset " + std::to_string(invalid), invalid};
+        }
+    }
+
+    /**
+     * Decode a HEX string (upper or lower case) into binary.
+     *
+     * @throws hex_error, see read_hex()
+     */
+    inline std::string convert_from_hex(const std::string& hex) {
+        std::string out(hex.size() / 2, '\0');
+        read_hex(&out[0], hex.data(), hex.size());
+        return out;
+    }
+
+    /**
+     * Decode a HEX string into the front of the same buffer and shrink it
+     * to the decoded size. No memory is allocated.
+     *
+     * @throws hex_error, see read_hex(). str is unchanged in this case
+     *         if the error was an odd length, otherwise it is undefined.
+     */
+    inline void convert_from_hex_inplace(std::string& str) {
+        read_hex(&str[0], str.data(), str.size());
+        str.resize(str.size() / 2);
+    }
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_HEX_HPP */
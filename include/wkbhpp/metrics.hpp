@@ -0,0 +1,317 @@
+#ifndef WKBHPP_METRICS_HPP
+#define WKBHPP_METRICS_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/bbox.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace wkbhpp {
+
+    /**
+     * A point returned by the metrics policies.
+     */
+    struct location {
+        double x;
+        double y;
+    }; // struct location
+
+    /**
+     * Metrics policy of GenericWKBWriter which does nothing (the
+     * default). It has the same hooks as the bounding box policies, see
+     * no_bbox.
+     */
+    using no_metrics = no_bbox;
+
+    /**
+     * Length and area calculation in the plane, in units of the
+     * coordinates.
+     */
+    struct planar_calc {
+
+        static double length(const double x1, const double y1, const double x2, const double y2) noexcept {
+            const double dx = x2 - x1;
+            const double dy = y2 - y1;
+            return std::sqrt(dx * dx + dy * dy);
+        }
+
+        /**
+         * Contribution of a segment to the signed area of a closed ring
+         * (shoelace formula). cross is the cross product of both points
+         * relative to the first point of the ring.
+         */
+        static double area(double /*x1*/, double /*y1*/, double /*x2*/, double /*y2*/, const double cross) noexcept {
+            return cross / 2;
+        }
+
+    }; // struct planar_calc
+
+    /**
+     * Length and area calculation on a sphere with the mean radius of the
+     * earth for longitude/latitude coordinates in degrees (EPSG:4326).
+     * Lengths are in meters, areas in square meters. The errors compared
+     * with the WGS84 ellipsoid are below 0.5 %.
+     */
+    struct spherical_calc {
+
+        static constexpr double earth_radius = 6371008.8;
+
+        static double radians(const double degrees) noexcept {
+            return degrees * (3.14159265358979323846 / 180.0);
+        }
+
+        // haversine formula
+        static double length(const double x1, const double y1, const double x2, const double y2) noexcept {
+            const double sin_dlat = std::sin(radians(y2 - y1) / 2);
+            const double sin_dlon = std::sin(radians(x2 - x1) / 2);
+            const double h = sin_dlat * sin_dlat + std::cos(radians(y1)) * std::cos(radians(y2)) * sin_dlon * sin_dlon;
+            return 2 * earth_radius * std::asin(std::sqrt(std::min(h, 1.0)));
+        }
+
+        // Chamberlain and Duquette, "Some Algorithms for Polygons on a
+        // Sphere" (2007)
+        static double area(const double x1, const double y1, const double x2, const double y2, double /*cross*/) noexcept {
+            return -radians(x2 - x1) * (2 + std::sin(radians(y1)) + std::sin(radians(y2))) *
+                   (earth_radius * earth_radius / 2);
+        }
+
+    }; // struct spherical_calc
+
+    /**
+     * Metrics policy of GenericWKBWriter which computes the area, the
+     * length and the centroid of a geometry while its points are added.
+     * TCalc (planar_calc or spherical_calc) defines how lengths and areas
+     * are measured.
+     *
+     * - area(): area of all polygons. Outer rings count positive, inner
+     *   rings negative, whatever their orientation.
+     * - length(): length of all linestrings plus the perimeter of all
+     *   rings.
+     * - ring_areas(): signed area of each ring in the order they were
+     *   added, positive for counterclockwise rings.
+     * - centroid(): area-weighted centroid of the polygons. Geometries
+     *   without area fall back to the length-weighted centroid of their
+     *   segments and then to the mean of their points. The centroid is
+     *   always computed in the plane of the coordinates.
+     *
+     * Rings are expected to be closed as required by WKB.
+     */
+    template <typename TCalc>
+    class basic_metrics : public no_metrics {
+
+        // state of the open linestring or ring
+        bool m_in_path = false;
+        bool m_first = true;
+        double m_origin_x = 0;
+        double m_origin_y = 0;
+        double m_prev_x = 0;
+        double m_prev_y = 0;
+        double m_path_length = 0;
+        double m_ring_area = 0;
+        // planar shoelace sums relative to the first point of the ring
+        double m_ring_cross = 0;
+        double m_ring_moment_x = 0;
+        double m_ring_moment_y = 0;
+        std::size_t m_ring_in_polygon = 0;
+
+        double m_area = 0;
+        double m_length = 0;
+
+        // area-weighted centroid of the polygons
+        double m_area_moment_x = 0;
+        double m_area_moment_y = 0;
+        double m_area_weight = 0;
+
+        // length-weighted centroid of the segments
+        double m_line_moment_x = 0;
+        double m_line_moment_y = 0;
+        double m_line_weight = 0;
+
+        // mean of points outside of linestrings and rings
+        double m_point_sum_x = 0;
+        double m_point_sum_y = 0;
+        std::size_t m_point_count = 0;
+
+        std::vector<double> m_ring_areas;
+
+        void start_path() noexcept {
+            m_in_path = true;
+            m_first = true;
+            m_path_length = 0;
+            m_ring_area = 0;
+            m_ring_cross = 0;
+            m_ring_moment_x = 0;
+            m_ring_moment_y = 0;
+        }
+
+        void add_segment(const double x1, const double y1, const double x2, const double y2) noexcept {
+            const double dx1 = x1 - m_origin_x;
+            const double dy1 = y1 - m_origin_y;
+            const double dx2 = x2 - m_origin_x;
+            const double dy2 = y2 - m_origin_y;
+            const double cross = dx1 * dy2 - dx2 * dy1;
+            m_ring_cross += cross;
+            m_ring_moment_x += (dx1 + dx2) * cross;
+            m_ring_moment_y += (dy1 + dy2) * cross;
+            m_ring_area += TCalc::area(x1, y1, x2, y2, cross);
+
+            m_path_length += TCalc::length(x1, y1, x2, y2);
+            const double planar_length = planar_calc::length(x1, y1, x2, y2);
+            m_line_moment_x += planar_length * (x1 + x2) / 2;
+            m_line_moment_y += planar_length * (y1 + y2) / 2;
+            m_line_weight += planar_length;
+        }
+
+    public:
+
+        basic_metrics() = default;
+
+        /**
+         * Start over, keeping the capacity of ring_areas().
+         */
+        void reset() noexcept {
+            std::vector<double> ring_areas{std::move(m_ring_areas)};
+            ring_areas.clear();
+            *this = basic_metrics{};
+            m_ring_areas = std::move(ring_areas);
+        }
+
+        void add_point(const double x, const double y) noexcept {
+            if (!m_in_path) {
+                m_point_sum_x += x;
+                m_point_sum_y += y;
+                ++m_point_count;
+                return;
+            }
+            if (m_first) {
+                m_first = false;
+                m_origin_x = x;
+                m_origin_y = y;
+            } else {
+                add_segment(m_prev_x, m_prev_y, x, y);
+            }
+            m_prev_x = x;
+            m_prev_y = y;
+        }
+
+        void add_points(const double* coords, const std::size_t n, const std::size_t stride) noexcept {
+            for (std::size_t i = 0; i < n; ++i, coords += stride) {
+                add_point(coords[0], coords[1]);
+            }
+        }
+
+        void add_points(const double* x, const double* y, const std::size_t n) noexcept {
+            for (std::size_t i = 0; i < n; ++i) {
+                add_point(x[i], y[i]);
+            }
+        }
+
+        void linestring_start() noexcept {
+            start_path();
+        }
+
+        void linestring_finish() noexcept {
+            m_length += m_path_length;
+            m_in_path = false;
+        }
+
+        void ring_start() noexcept {
+            start_path();
+        }
+
+        void ring_finish() {
+            m_ring_areas.push_back(m_ring_area);
+            const double sign = m_ring_in_polygon == 0 ? 1.0 : -1.0;
+            m_area += sign * std::abs(m_ring_area);
+            m_length += m_path_length;
+
+            if (m_ring_cross != 0) {
+                // weight of the ring: its planar area, negative for holes
+                const double weight = sign * std::abs(m_ring_cross) / 2;
+                m_area_moment_x += weight * (m_ring_moment_x / (3 * m_ring_cross) + m_origin_x);
+                m_area_moment_y += weight * (m_ring_moment_y / (3 * m_ring_cross) + m_origin_y);
+                m_area_weight += weight;
+            }
+
+            ++m_ring_in_polygon;
+            m_in_path = false;
+        }
+
+        void polygon_start() noexcept {
+            m_ring_in_polygon = 0;
+        }
+
+        double area() const noexcept {
+            return m_area;
+        }
+
+        double length() const noexcept {
+            return m_length;
+        }
+
+        const std::vector<double>& ring_areas() const noexcept {
+            return m_ring_areas;
+        }
+
+        /**
+         * Centroid of the geometry, NaN/NaN for empty geometries.
+         */
+        location centroid() const noexcept {
+            if (m_area_weight != 0) {
+                return location{m_area_moment_x / m_area_weight, m_area_moment_y / m_area_weight};
+            }
+            if (m_line_weight != 0) {
+                return location{m_line_moment_x / m_line_weight, m_line_moment_y / m_line_weight};
+            }
+            if (m_point_count != 0) {
+                return location{m_point_sum_x / m_point_count, m_point_sum_y / m_point_count};
+            }
+            return location{std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()};
+        }
+
+    }; // class basic_metrics
+
+    using planar_metrics = basic_metrics<planar_calc>;
+
+    using spherical_metrics = basic_metrics<spherical_calc>;
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_METRICS_HPP */
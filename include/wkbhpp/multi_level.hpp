@@ -0,0 +1,395 @@
+#ifndef WKBHPP_MULTI_LEVEL_HPP
+#define WKBHPP_MULTI_LEVEL_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/error.hpp>
+#include <wkbhpp/simplify.hpp>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wkbhpp {
+
+    /**
+     * Writer producing the same geometry at several simplification levels
+     * in one pass. Points go in once through the usual add_location
+     * methods (so they only have to be looked up and projected once) and
+     * every finish method appends level i to out[i].
+     *
+     * Each level has its own writer and output buffer. Each linestring
+     * or ring is ranked once (see detail::simplify_ranks()), then the
+     * points surviving each tolerance are added to the writer of that
+     * level in bulk. A tolerance of 0 keeps all points except collinear
+     * ones.
+     *
+     * Like Simplifier it supports LineStrings, Polygons, MultiLineStrings
+     * and MultiPolygons.
+     */
+    template <typename TWriter>
+    class MultiLevelWriter {
+
+        std::vector<TWriter> m_writers;
+        std::vector<double> m_tolerances;
+        simplify_algorithm m_algorithm;
+
+        // points of the open linestring or ring, shared by all levels
+        std::vector<double> m_points;
+        detail::simplify_scratch m_scratch;
+
+        std::size_t stride() const noexcept {
+            return m_writers.front().format().stride();
+        }
+
+        void add(const double* coords, const std::size_t n) {
+            if (n != stride()) {
+                throw wkb_error{"Number of coordinates does not match the dimensions of the writer"};
+            }
+            m_points.insert(m_points.end(), coords, coords + n);
+        }
+
+        void add_bulk(const double* coords, const std::size_t n) {
+            m_points.insert(m_points.end(), coords, coords + n * stride());
+        }
+
+        /**
+         * Rank the buffered points once, then call func(writer, coords,
+         * count) with the surviving points for each level.
+         */
+        template <typename TFunc>
+        void flush(bool ring, TFunc&& func) {
+            const std::size_t n = m_points.size() / stride();
+            detail::simplify_ranks(m_points.data(), n, stride(), m_algorithm, ring, m_scratch);
+            for (std::size_t i = 0; i < m_writers.size(); ++i) {
+                const std::size_t count = detail::select_points(m_points.data(), n, stride(), m_tolerances[i],
+                                                                m_algorithm, m_scratch);
+                func(m_writers[i], m_scratch.out.data(), count);
+            }
+            m_points.clear();
+        }
+
+        void flush_ring() {
+            flush(true, [](TWriter& writer, const double* coords, std::size_t count) {
+                writer.multipolygon_add_locations(coords, count);
+            });
+        }
+
+        template <typename TFunc>
+        void for_each_writer(TFunc&& func) {
+            for (auto& writer : m_writers) {
+                func(writer);
+            }
+        }
+
+        static void prepare(std::vector<std::string>& out, std::size_t levels) {
+            if (out.size() < levels) {
+                out.resize(levels);
+            }
+        }
+
+    public:
+
+        /**
+         * Create a writer for the given tolerances (one level each). The
+         * writers of the levels are copies of prototype, i.e. they share
+         * its format, SRID and policies.
+         */
+        MultiLevelWriter(const TWriter& prototype, std::vector<double> tolerances,
+                         simplify_algorithm algorithm = simplify_algorithm::douglas_peucker) :
+            m_writers(tolerances.size(), prototype),
+            m_tolerances(std::move(tolerances)),
+            m_algorithm(algorithm) {
+            if (m_tolerances.empty()) {
+                throw wkb_error{"MultiLevelWriter needs at least one level"};
+            }
+        }
+
+        std::size_t levels() const noexcept {
+            return m_writers.size();
+        }
+
+        double tolerance(std::size_t level) const noexcept {
+            return m_tolerances[level];
+        }
+
+        /**
+         * The writer of a level, e.g. to look at its bbox() or metrics().
+         */
+        const TWriter& writer(std::size_t level) const noexcept {
+            return m_writers[level];
+        }
+
+        /* LineString */
+
+        void linestring_start() {
+            m_points.clear();
+            for_each_writer([](TWriter& writer) {
+                writer.linestring_start();
+            });
+        }
+
+        /**
+         * Add a point of the linestring. Like with the writer, the number
+         * of coordinates must match its dimensions. This holds for all
+         * add_location methods.
+         */
+        void linestring_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void linestring_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void linestring_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        /**
+         * Add n points given as interleaved coordinates, see
+         * GenericWKBWriter::linestring_add_locations(). This holds for
+         * all add_locations methods.
+         */
+        void linestring_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        /**
+         * Finish the linestring and append level i to out[i]. out is
+         * resized to levels() entries if it is smaller. This holds for
+         * all finish methods.
+         */
+        void linestring_finish(std::vector<std::string>& out) {
+            prepare(out, levels());
+            std::size_t level = 0;
+            flush(false, [&](TWriter& writer, const double* coords, std::size_t count) {
+                writer.linestring_add_locations(coords, count);
+                writer.linestring_finish(count, out[level++]);
+            });
+        }
+
+        /* Polygon */
+
+        void polygon_start() {
+            for_each_writer([](TWriter& writer) {
+                writer.polygon_start();
+            });
+        }
+
+        void polygon_outer_ring_start() {
+            m_points.clear();
+            for_each_writer([](TWriter& writer) {
+                writer.polygon_outer_ring_start();
+            });
+        }
+
+        void polygon_outer_ring_finish() {
+            flush_ring();
+            for_each_writer([](TWriter& writer) {
+                writer.polygon_outer_ring_finish();
+            });
+        }
+
+        void polygon_inner_ring_start() {
+            m_points.clear();
+            for_each_writer([](TWriter& writer) {
+                writer.polygon_inner_ring_start();
+            });
+        }
+
+        void polygon_inner_ring_finish() {
+            flush_ring();
+            for_each_writer([](TWriter& writer) {
+                writer.polygon_inner_ring_finish();
+            });
+        }
+
+        void polygon_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void polygon_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void polygon_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        void polygon_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        void polygon_finish(std::vector<std::string>& out) {
+            prepare(out, levels());
+            for (std::size_t i = 0; i < levels(); ++i) {
+                m_writers[i].polygon_finish(out[i]);
+            }
+        }
+
+        /* MultiLineString */
+
+        void multilinestring_start() {
+            for_each_writer([](TWriter& writer) {
+                writer.multilinestring_start();
+            });
+        }
+
+        void multilinestring_linestring_start() {
+            m_points.clear();
+            for_each_writer([](TWriter& writer) {
+                writer.multilinestring_linestring_start();
+            });
+        }
+
+        void multilinestring_linestring_finish() {
+            flush(false, [](TWriter& writer, const double* coords, std::size_t count) {
+                writer.multilinestring_add_locations(coords, count);
+                writer.multilinestring_linestring_finish();
+            });
+        }
+
+        void multilinestring_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void multilinestring_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void multilinestring_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        void multilinestring_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        void multilinestring_finish(std::vector<std::string>& out) {
+            prepare(out, levels());
+            for (std::size_t i = 0; i < levels(); ++i) {
+                m_writers[i].multilinestring_finish(out[i]);
+            }
+        }
+
+        /* MultiPolygon */
+
+        void multipolygon_start() {
+            for_each_writer([](TWriter& writer) {
+                writer.multipolygon_start();
+            });
+        }
+
+        void multipolygon_polygon_start() {
+            for_each_writer([](TWriter& writer) {
+                writer.multipolygon_polygon_start();
+            });
+        }
+
+        void multipolygon_polygon_finish() {
+            for_each_writer([](TWriter& writer) {
+                writer.multipolygon_polygon_finish();
+            });
+        }
+
+        void multipolygon_outer_ring_start() {
+            m_points.clear();
+            for_each_writer([](TWriter& writer) {
+                writer.multipolygon_outer_ring_start();
+            });
+        }
+
+        void multipolygon_outer_ring_finish() {
+            flush_ring();
+            for_each_writer([](TWriter& writer) {
+                writer.multipolygon_outer_ring_finish();
+            });
+        }
+
+        void multipolygon_inner_ring_start() {
+            m_points.clear();
+            for_each_writer([](TWriter& writer) {
+                writer.multipolygon_inner_ring_start();
+            });
+        }
+
+        void multipolygon_inner_ring_finish() {
+            flush_ring();
+            for_each_writer([](TWriter& writer) {
+                writer.multipolygon_inner_ring_finish();
+            });
+        }
+
+        void multipolygon_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void multipolygon_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void multipolygon_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        void multipolygon_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        void multipolygon_finish(std::vector<std::string>& out) {
+            prepare(out, levels());
+            for (std::size_t i = 0; i < levels(); ++i) {
+                m_writers[i].multipolygon_finish(out[i]);
+            }
+        }
+
+    }; // class MultiLevelWriter
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_MULTI_LEVEL_HPP */
@@ -0,0 +1,191 @@
+#ifndef WKBHPP_POINT_TRAITS_HPP
+#define WKBHPP_POINT_TRAITS_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace wkbhpp {
+
+    namespace detail {
+
+        template <typename... Ts>
+        struct make_void {
+            using type = void;
+        };
+
+        template <typename... Ts>
+        using void_t = typename make_void<Ts...>::type;
+
+        template <typename T, typename = void>
+        struct has_xy_members : std::false_type {
+        };
+
+        template <typename T>
+        struct has_xy_members<T, void_t<decltype(std::declval<const T&>().x), decltype(std::declval<const T&>().y)>> :
+            std::true_type {
+        };
+
+        template <typename T, typename = void>
+        struct has_xy_functions : std::false_type {
+        };
+
+        template <typename T>
+        struct has_xy_functions<T, void_t<decltype(std::declval<const T&>().x()), decltype(std::declval<const T&>().y())>> :
+            std::true_type {
+        };
+
+        /**
+         * Check that T consists of nothing but its members x and y, two
+         * doubles in this order. The checks are nested so that offsetof
+         * is only used on standard layout types.
+         */
+        template <typename T, bool = std::is_trivially_copyable<T>::value && std::is_standard_layout<T>::value &&
+                                     sizeof(T) == 2 * sizeof(double)>
+        struct xy_member_layout : std::false_type {
+        };
+
+        template <typename T>
+        struct xy_member_layout<T, true> : std::integral_constant<bool,
+            std::is_same<decltype(T::x), double>::value &&
+            std::is_same<decltype(T::y), double>::value &&
+            offsetof(T, x) == 0 &&
+            offsetof(T, y) == sizeof(double)> {
+        };
+
+    } // namespace detail
+
+    /**
+     * Access to the coordinates of point types used with the generic
+     * methods of WKBWriter.
+     *
+     * Types with public x and y members or x() and y() member functions
+     * (e.g. osmium::geom::Coordinates, boost::geometry::model::d2::point_xy)
+     * and std::pair are supported out of the box. Specialize this template
+     * for other types.
+     *
+     * xy_layout is true if an array of the type has the same memory layout
+     * as an array of interleaved x/y doubles. In this case the writer copies
+     * the coordinates with a single memcpy.
+     */
+    template <typename T, typename = void>
+    struct point_traits;
+
+    template <typename T>
+    struct point_traits<T, typename std::enable_if<detail::has_xy_members<T>::value>::type> {
+
+        static constexpr const bool xy_layout = detail::xy_member_layout<T>::value;
+
+        static double x(const T& point) {
+            return point.x;
+        }
+
+        static double y(const T& point) {
+            return point.y;
+        }
+
+    }; // struct point_traits
+
+    template <typename T>
+    struct point_traits<T, typename std::enable_if<!detail::has_xy_members<T>::value &&
+                                                   detail::has_xy_functions<T>::value>::type> {
+
+        static constexpr const bool xy_layout = false;
+
+        static double x(const T& point) {
+            return point.x();
+        }
+
+        static double y(const T& point) {
+            return point.y();
+        }
+
+    }; // struct point_traits
+
+    template <typename TX, typename TY>
+    struct point_traits<std::pair<TX, TY>> {
+
+        static constexpr const bool xy_layout =
+            std::is_same<TX, double>::value && std::is_same<TY, double>::value &&
+            std::is_trivially_copyable<std::pair<TX, TY>>::value &&
+            std::is_standard_layout<std::pair<TX, TY>>::value &&
+            sizeof(std::pair<TX, TY>) == 2 * sizeof(double);
+
+        static double x(const std::pair<TX, TY>& point) {
+            return point.first;
+        }
+
+        static double y(const std::pair<TX, TY>& point) {
+            return point.second;
+        }
+
+    }; // struct point_traits
+
+    namespace detail {
+
+        template <typename TIterator>
+        using iterator_value_type = typename std::decay<decltype(*std::declval<TIterator>())>::type;
+
+        /**
+         * True if TIterator is a pointer to points with xy_layout.
+         */
+        template <typename TIterator>
+        struct is_xy_pointer : std::integral_constant<bool,
+            std::is_pointer<TIterator>::value &&
+            point_traits<iterator_value_type<TIterator>>::xy_layout> {
+        };
+
+        template <typename TRange, typename = void>
+        struct is_contiguous_range : std::false_type {
+        };
+
+        // data() must point to the elements of the range, not to some
+        // underlying storage of another type
+        template <typename TRange>
+        struct is_contiguous_range<TRange, void_t<decltype(std::declval<const TRange&>().data()),
+                                                  decltype(std::declval<const TRange&>().size())>> :
+            std::integral_constant<bool,
+                std::is_pointer<decltype(std::declval<const TRange&>().data())>::value &&
+                std::is_same<typename std::remove_cv<typename std::remove_pointer<decltype(std::declval<const TRange&>().data())>::type>::type,
+                             typename std::remove_cv<typename std::remove_reference<decltype(*std::begin(std::declval<const TRange&>()))>::type>::type>::value> {
+        };
+
+    } // namespace detail
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_POINT_TRAITS_HPP */
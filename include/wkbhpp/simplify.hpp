@@ -0,0 +1,589 @@
+#ifndef WKBHPP_SIMPLIFY_HPP
+#define WKBHPP_SIMPLIFY_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/error.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wkbhpp {
+
+    enum class simplify_algorithm : uint8_t {
+        // drop points closer than the tolerance to the simplified line
+        douglas_peucker = 0,
+        // drop points spanning triangles smaller than tolerance² with
+        // their neighbours
+        visvalingam     = 1
+    }; // enum class simplify_algorithm
+
+    namespace detail {
+
+        /**
+         * Memory used by the simplification functions. All vectors keep
+         * their capacity, so simplifying many geometries with the same
+         * scratch only allocates until the largest one has been seen.
+         */
+        struct simplify_scratch {
+            struct range {
+                std::size_t first;
+                std::size_t last;
+                // smallest rank of the points this range was split at
+                double limit;
+            };
+
+            struct heap_entry {
+                double area;
+                std::size_t index;
+
+                bool operator<(const heap_entry& other) const noexcept {
+                    // std::push_heap() builds a max-heap, smallest area on top
+                    return area > other.area;
+                }
+            };
+
+            // per point: the squared tolerance up to which it survives
+            std::vector<double> ranks;
+
+            std::vector<range> ranges;
+            std::vector<char> removed;
+            std::vector<std::size_t> prev;
+            std::vector<std::size_t> next;
+            std::vector<heap_entry> heap;
+
+            // coordinates of the surviving points
+            std::vector<double> out;
+        };
+
+        /**
+         * Squared distance of point p from the segment a-b.
+         */
+        inline double segment_distance_squared(const double* p, const double* a, const double* b) noexcept {
+            const double dx = b[0] - a[0];
+            const double dy = b[1] - a[1];
+            double x = a[0];
+            double y = a[1];
+            const double length_squared = dx * dx + dy * dy;
+            if (length_squared > 0) {
+                const double t = ((p[0] - a[0]) * dx + (p[1] - a[1]) * dy) / length_squared;
+                if (t >= 1) {
+                    x = b[0];
+                    y = b[1];
+                } else if (t > 0) {
+                    x += t * dx;
+                    y += t * dy;
+                }
+            }
+            return (p[0] - x) * (p[0] - x) + (p[1] - y) * (p[1] - y);
+        }
+
+        /**
+         * Rank the n points with stride doubles each (x and y first) at
+         * coords for Ramer-Douglas-Peucker simplification: a point is kept
+         * with tolerance t if its rank is greater than t². The rank is its
+         * squared distance from the segment it splits, limited by the
+         * ranks of the points splitting the ranges around it, so that one
+         * ranking serves all tolerances.
+         *
+         * The first and the last point are always kept. Rings are split at
+         * the point farthest from their first point and the farthest point
+         * of each half is kept as well, so that rings with at least 5
+         * points keep at least 5.
+         */
+        inline void douglas_peucker_ranks(const double* coords, std::size_t n, std::size_t stride, bool ring,
+                                          simplify_scratch& scratch) {
+            constexpr const double always = std::numeric_limits<double>::infinity();
+            scratch.ranks.assign(n, 0);
+            if (n == 0) {
+                return;
+            }
+            scratch.ranks[0] = always;
+            scratch.ranks[n - 1] = always;
+
+            scratch.ranges.clear();
+            if (ring && n > 4) {
+                std::size_t farthest = 1;
+                double max_distance = -1;
+                for (std::size_t i = 1; i < n - 1; ++i) {
+                    const double dx = coords[i * stride] - coords[0];
+                    const double dy = coords[i * stride + 1] - coords[1];
+                    if (dx * dx + dy * dy > max_distance) {
+                        max_distance = dx * dx + dy * dy;
+                        farthest = i;
+                    }
+                }
+                scratch.ranks[farthest] = always;
+                // a negative limit marks the ranges whose split point is always kept
+                scratch.ranges.push_back(simplify_scratch::range{0, farthest, -1});
+                scratch.ranges.push_back(simplify_scratch::range{farthest, n - 1, -1});
+            } else if (ring) {
+                std::fill(scratch.ranks.begin(), scratch.ranks.end(), always);
+            } else {
+                scratch.ranges.push_back(simplify_scratch::range{0, n - 1, always});
+            }
+
+            while (!scratch.ranges.empty()) {
+                const simplify_scratch::range r = scratch.ranges.back();
+                scratch.ranges.pop_back();
+                if (r.last - r.first < 2) {
+                    continue;
+                }
+                std::size_t farthest = r.first + 1;
+                double max_distance = -1;
+                for (std::size_t i = r.first + 1; i < r.last; ++i) {
+                    const double d = segment_distance_squared(coords + i * stride, coords + r.first * stride,
+                                                              coords + r.last * stride);
+                    if (d > max_distance) {
+                        max_distance = d;
+                        farthest = i;
+                    }
+                }
+                const double rank = r.limit < 0 ? always : std::min(max_distance, r.limit);
+                scratch.ranks[farthest] = rank;
+                if (rank > 0) {
+                    scratch.ranges.push_back(simplify_scratch::range{r.first, farthest, rank});
+                    scratch.ranges.push_back(simplify_scratch::range{farthest, r.last, rank});
+                }
+            }
+        }
+
+        inline double triangle_area(const double* a, const double* b, const double* c) noexcept {
+            return std::abs((b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1])) / 2;
+        }
+
+        /**
+         * Rank the points for Visvalingam-Whyatt simplification, see
+         * douglas_peucker_ranks(). Points are removed smallest effective
+         * area first, the rank of a point is its effective area when it
+         * is removed. Rings keep at least 4 points, linestrings 2.
+         */
+        inline void visvalingam_ranks(const double* coords, std::size_t n, std::size_t stride, bool ring,
+                                      simplify_scratch& scratch) {
+            scratch.ranks.assign(n, std::numeric_limits<double>::infinity());
+            const std::size_t min_points = ring ? 4 : 2;
+            if (n <= min_points) {
+                return;
+            }
+
+            std::vector<double>& areas = scratch.ranks;
+            scratch.removed.assign(n, 0);
+            scratch.prev.resize(n);
+            scratch.next.resize(n);
+            scratch.heap.clear();
+            const auto point = [coords, stride](std::size_t i) {
+                return coords + i * stride;
+            };
+            for (std::size_t i = 1; i < n - 1; ++i) {
+                scratch.prev[i] = i - 1;
+                scratch.next[i] = i + 1;
+                areas[i] = triangle_area(point(i - 1), point(i), point(i + 1));
+                scratch.heap.push_back(simplify_scratch::heap_entry{areas[i], i});
+            }
+            std::make_heap(scratch.heap.begin(), scratch.heap.end());
+
+            std::size_t remaining = n;
+            double max_removed = 0;
+            while (!scratch.heap.empty() && remaining > min_points) {
+                std::pop_heap(scratch.heap.begin(), scratch.heap.end());
+                const simplify_scratch::heap_entry e = scratch.heap.back();
+                scratch.heap.pop_back();
+                if (scratch.removed[e.index] || e.area != areas[e.index]) {
+                    continue; // removed already or outdated entry
+                }
+                // areas never decrease along the removal order
+                max_removed = std::max(max_removed, e.area);
+                areas[e.index] = max_removed;
+                scratch.removed[e.index] = 1;
+                --remaining;
+
+                const std::size_t p = scratch.prev[e.index];
+                const std::size_t q = scratch.next[e.index];
+                if (p != 0) {
+                    scratch.next[p] = q;
+                    areas[p] = std::max(max_removed, triangle_area(point(scratch.prev[p]), point(p), point(q)));
+                    scratch.heap.push_back(simplify_scratch::heap_entry{areas[p], p});
+                    std::push_heap(scratch.heap.begin(), scratch.heap.end());
+                }
+                if (q != n - 1) {
+                    scratch.prev[q] = p;
+                    areas[q] = std::max(max_removed, triangle_area(point(p), point(q), point(scratch.next[q])));
+                    scratch.heap.push_back(simplify_scratch::heap_entry{areas[q], q});
+                    std::push_heap(scratch.heap.begin(), scratch.heap.end());
+                }
+            }
+            // the points left over are always kept
+            for (std::size_t i = 1; i < n - 1; ++i) {
+                if (!scratch.removed[i]) {
+                    areas[i] = std::numeric_limits<double>::infinity();
+                }
+            }
+        }
+
+        inline void simplify_ranks(const double* coords, std::size_t n, std::size_t stride,
+                                   simplify_algorithm algorithm, bool ring, simplify_scratch& scratch) {
+            if (algorithm == simplify_algorithm::visvalingam) {
+                visvalingam_ranks(coords, n, stride, ring, scratch);
+            } else {
+                douglas_peucker_ranks(coords, n, stride, ring, scratch);
+            }
+        }
+
+        /**
+         * Copy the points which survive simplification with the given
+         * tolerance to scratch.out. scratch.ranks must have been filled by
+         * simplify_ranks().
+         *
+         * @returns the number of surviving points
+         */
+        inline std::size_t select_points(const double* coords, std::size_t n, std::size_t stride, double tolerance,
+                                         simplify_algorithm algorithm, simplify_scratch& scratch) {
+            const double threshold = tolerance * tolerance;
+            scratch.out.clear();
+            for (std::size_t i = 0; i < n; ++i) {
+                const double rank = scratch.ranks[i];
+                if (algorithm == simplify_algorithm::visvalingam ? rank >= threshold : rank > threshold) {
+                    scratch.out.insert(scratch.out.end(), coords + i * stride, coords + (i + 1) * stride);
+                }
+            }
+            return scratch.out.size() / stride;
+        }
+
+        /**
+         * Simplify the points at coords and copy the surviving ones to
+         * scratch.out.
+         *
+         * @returns the number of surviving points
+         */
+        inline std::size_t simplify(const double* coords, std::size_t n, std::size_t stride, double tolerance,
+                                    simplify_algorithm algorithm, bool ring, simplify_scratch& scratch) {
+            simplify_ranks(coords, n, stride, algorithm, ring, scratch);
+            return select_points(coords, n, stride, tolerance, algorithm, scratch);
+        }
+
+    } // namespace detail
+
+    /**
+     * Simplification stage in front of a writer (WKBWriter or any other
+     * GenericWKBWriter). It has the start/add/finish methods of the
+     * writer for LineStrings, Polygons, MultiLineStrings and MultiPolygons.
+     * The points of each linestring or ring are buffered, simplified when
+     * the linestring or ring is finished, and the surviving points are
+     * added to the writer in bulk. Points and GeometryCollections are
+     * written with writer() directly.
+     *
+     * The number of points of a linestring is only known after
+     * simplification, so linestring_finish() takes no count.
+     *
+     * Rings stay closed and keep at least 4 points (rings with fewer
+     * points are written unchanged). All buffers are reused between
+     * geometries.
+     */
+    template <typename TWriter>
+    class Simplifier {
+
+        TWriter& m_writer;
+        double m_tolerance;
+        simplify_algorithm m_algorithm;
+
+        // points of the open linestring or ring
+        std::vector<double> m_points;
+        detail::simplify_scratch m_scratch;
+
+        void add(const double* coords, const std::size_t n) {
+            if (n != m_writer.format().stride()) {
+                throw wkb_error{"Number of coordinates does not match the dimensions of the writer"};
+            }
+            m_points.insert(m_points.end(), coords, coords + n);
+        }
+
+        void add_bulk(const double* coords, const std::size_t n) {
+            m_points.insert(m_points.end(), coords, coords + n * m_writer.format().stride());
+        }
+
+        /**
+         * Simplify the buffered points and clear the buffer.
+         *
+         * @returns the number of surviving points, which are in m_scratch.out
+         */
+        std::size_t simplify(bool ring) {
+            const std::size_t stride = m_writer.format().stride();
+            const std::size_t count = detail::simplify(m_points.data(), m_points.size() / stride, stride,
+                                                       m_tolerance, m_algorithm, ring, m_scratch);
+            m_points.clear();
+            return count;
+        }
+
+        void finish_ring() {
+            const std::size_t count = simplify(true);
+            m_writer.multipolygon_add_locations(m_scratch.out.data(), count);
+        }
+
+    public:
+
+        Simplifier(TWriter& writer, double tolerance, simplify_algorithm algorithm = simplify_algorithm::douglas_peucker) :
+            m_writer(writer),
+            m_tolerance(tolerance),
+            m_algorithm(algorithm) {
+        }
+
+        TWriter& writer() noexcept {
+            return m_writer;
+        }
+
+        double tolerance() const noexcept {
+            return m_tolerance;
+        }
+
+        void set_tolerance(double tolerance) noexcept {
+            m_tolerance = tolerance;
+        }
+
+        /* LineString */
+
+        void linestring_start() {
+            m_points.clear();
+            m_writer.linestring_start();
+        }
+
+        /**
+         * Add a point of the linestring. Like with the writer, the number
+         * of coordinates must match its dimensions. This holds for all
+         * add_location methods.
+         */
+        void linestring_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void linestring_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void linestring_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        /**
+         * Add n points given as interleaved coordinates, see
+         * GenericWKBWriter::linestring_add_locations(). This holds for
+         * all add_locations methods.
+         */
+        void linestring_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        std::string linestring_finish() {
+            const std::size_t count = simplify(false);
+            m_writer.linestring_add_locations(m_scratch.out.data(), count);
+            return m_writer.linestring_finish(count);
+        }
+
+        void linestring_finish(std::string& out) {
+            const std::size_t count = simplify(false);
+            m_writer.linestring_add_locations(m_scratch.out.data(), count);
+            m_writer.linestring_finish(count, out);
+        }
+
+        /* Polygon */
+
+        void polygon_start() {
+            m_writer.polygon_start();
+        }
+
+        void polygon_outer_ring_start() {
+            m_points.clear();
+            m_writer.polygon_outer_ring_start();
+        }
+
+        void polygon_outer_ring_finish() {
+            finish_ring();
+            m_writer.polygon_outer_ring_finish();
+        }
+
+        void polygon_inner_ring_start() {
+            m_points.clear();
+            m_writer.polygon_inner_ring_start();
+        }
+
+        void polygon_inner_ring_finish() {
+            finish_ring();
+            m_writer.polygon_inner_ring_finish();
+        }
+
+        void polygon_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void polygon_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void polygon_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        void polygon_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        std::string polygon_finish() {
+            return m_writer.polygon_finish();
+        }
+
+        void polygon_finish(std::string& out) {
+            m_writer.polygon_finish(out);
+        }
+
+        /* MultiLineString */
+
+        void multilinestring_start() {
+            m_writer.multilinestring_start();
+        }
+
+        void multilinestring_linestring_start() {
+            m_points.clear();
+            m_writer.multilinestring_linestring_start();
+        }
+
+        void multilinestring_linestring_finish() {
+            const std::size_t count = simplify(false);
+            m_writer.multilinestring_add_locations(m_scratch.out.data(), count);
+            m_writer.multilinestring_linestring_finish();
+        }
+
+        void multilinestring_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void multilinestring_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void multilinestring_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        void multilinestring_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        std::string multilinestring_finish() {
+            return m_writer.multilinestring_finish();
+        }
+
+        void multilinestring_finish(std::string& out) {
+            m_writer.multilinestring_finish(out);
+        }
+
+        /* MultiPolygon */
+
+        void multipolygon_start() {
+            m_writer.multipolygon_start();
+        }
+
+        void multipolygon_polygon_start() {
+            m_writer.multipolygon_polygon_start();
+        }
+
+        void multipolygon_polygon_finish() {
+            m_writer.multipolygon_polygon_finish();
+        }
+
+        void multipolygon_outer_ring_start() {
+            m_points.clear();
+            m_writer.multipolygon_outer_ring_start();
+        }
+
+        void multipolygon_outer_ring_finish() {
+            finish_ring();
+            m_writer.multipolygon_outer_ring_finish();
+        }
+
+        void multipolygon_inner_ring_start() {
+            m_points.clear();
+            m_writer.multipolygon_inner_ring_start();
+        }
+
+        void multipolygon_inner_ring_finish() {
+            finish_ring();
+            m_writer.multipolygon_inner_ring_finish();
+        }
+
+        void multipolygon_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void multipolygon_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void multipolygon_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        void multipolygon_add_locations(const double* coords, const std::size_t n) {
+            add_bulk(coords, n);
+        }
+
+        std::string multipolygon_finish() {
+            return m_writer.multipolygon_finish();
+        }
+
+        void multipolygon_finish(std::string& out) {
+            m_writer.multipolygon_finish(out);
+        }
+
+    }; // class Simplifier
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_SIMPLIFY_HPP */
@@ -0,0 +1,385 @@
+#ifndef WKBHPP_SUBDIVIDE_HPP
+#define WKBHPP_SUBDIVIDE_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/clip.hpp>
+#include <wkbhpp/error.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wkbhpp {
+
+    /**
+     * Deepest level of quadrants a polygon is split into. Pieces on this
+     * level are written even if they still have too many points.
+     */
+    constexpr const std::size_t max_subdivision_depth = 20;
+
+    namespace detail {
+
+        /**
+         * Find a value c between the smallest and largest coordinate along
+         * axis, near the middle, which no point has.
+         *
+         * @returns false if there is none
+         */
+        inline bool split_value(const std::vector<double>& coords, const std::size_t stride, const std::size_t axis,
+                                double& c) noexcept {
+            double min = coords[axis];
+            double max = coords[axis];
+            for (std::size_t i = axis; i < coords.size(); i += stride) {
+                min = std::min(min, coords[i]);
+                max = std::max(max, coords[i]);
+            }
+            if (!(min < max)) {
+                return false;
+            }
+            c = min + (max - min) / 2;
+            for (int attempt = 0; attempt < 64; ++attempt) {
+                bool taken = false;
+                double next = max;
+                for (std::size_t i = axis; i < coords.size(); i += stride) {
+                    taken = taken || coords[i] == c;
+                    if (coords[i] > c && coords[i] < next) {
+                        next = coords[i];
+                    }
+                }
+                if (!taken) {
+                    return true;
+                }
+                const double between = c + (next - c) / 2;
+                if (!(between > c && between < next)) {
+                    return false;
+                }
+                c = between;
+            }
+            return false;
+        }
+
+    } // namespace detail
+
+    /**
+     * Writes MultiPolygons with TWriter like the writer itself, but splits
+     * polygons with more than a given number of points (counted over all
+     * rings) into pieces, like ST_Subdivide in PostGIS.
+     *
+     * The points of each polygon are buffered until it is finished.
+     * Polygons below the limit are then passed to the writer unchanged
+     * and end up in one MultiPolygon. Larger polygons are cut into
+     * quadrants, recursively, until each piece is small enough. The cut
+     * lines go through the middle of the bounding box of a piece, moved
+     * a little if a point lies on them. Each piece becomes a MultiPolygon
+     * (a quadrant can hold several parts of a polygon), so that all
+     * results have the same type.
+     *
+     * Rings crossing a cut are connected along it, inner rings crossing
+     * a cut become part of the outer ring. For valid input the pieces are
+     * valid polygons with the outer rings counterclockwise and the inner
+     * rings clockwise. Pieces which do not get smaller when they are
+     * split are written as they are.
+     *
+     * All buffers are kept between geometries. The results are appended
+     * to a caller-owned batch buffer with an offsets vector, so nothing is
+     * allocated per piece.
+     */
+    template <typename TWriter>
+    class Subdivider {
+
+        TWriter& m_writer;
+        std::size_t m_max_points;
+
+        // the polygon being added
+        detail::polygon_list m_current;
+
+        // polygons above the limit, the first m_num_large are in use
+        std::vector<detail::polygon_list> m_large;
+        std::size_t m_num_large = 0;
+
+        // halves and quadrants of a piece on each level of the subdivision
+        std::vector<detail::polygon_list> m_halves;
+        std::vector<detail::polygon_list> m_quadrants;
+
+        detail::half_plane_scratch m_scratch;
+
+        // the MultiPolygon of the small polygons has been started
+        bool m_open = false;
+
+        std::size_t stride() const noexcept {
+            return m_writer.format().stride();
+        }
+
+        std::size_t num_points(const detail::polygon_list& polygons) const noexcept {
+            return polygons.coords.size() / stride();
+        }
+
+        void add(const double* coords, const std::size_t n) {
+            if (n != stride()) {
+                throw wkb_error{"Number of coordinates does not match the dimensions of the writer"};
+            }
+            m_current.coords.insert(m_current.coords.end(), coords, coords + n);
+        }
+
+        void finish_ring() {
+            m_current.ring_ends.push_back(num_points(m_current));
+        }
+
+        void write_member(const detail::polygon_list& polygons, const std::size_t p) {
+            m_writer.multipolygon_polygon_start();
+            for (std::size_t r = polygons.polygon_begin(p); r < polygons.polygon_ends[p]; ++r) {
+                const bool outer = r == polygons.polygon_begin(p);
+                if (outer) {
+                    m_writer.multipolygon_outer_ring_start();
+                } else {
+                    m_writer.multipolygon_inner_ring_start();
+                }
+                const std::size_t begin = polygons.ring_begin(r);
+                m_writer.multipolygon_add_locations(polygons.coords.data() + begin * stride(), polygons.ring_ends[r] - begin);
+                if (outer) {
+                    m_writer.multipolygon_outer_ring_finish();
+                } else {
+                    m_writer.multipolygon_inner_ring_finish();
+                }
+            }
+            m_writer.multipolygon_polygon_finish();
+        }
+
+        template <typename TOffset>
+        std::size_t write_piece(const detail::polygon_list& piece, std::string& batch, std::vector<TOffset>& offsets) {
+            m_writer.multipolygon_start();
+            for (std::size_t p = 0; p < piece.polygon_ends.size(); ++p) {
+                write_member(piece, p);
+            }
+            m_writer.multipolygon_finish(batch);
+            offsets.push_back(static_cast<TOffset>(batch.size()));
+            return 1;
+        }
+
+        /**
+         * Write piece or, if it is too large, its quadrants as separate
+         * MultiPolygons appended to batch.
+         *
+         * @returns the number of geometries appended
+         */
+        template <typename TOffset>
+        std::size_t subdivide(const detail::polygon_list& piece, const std::size_t depth, std::string& batch,
+                              std::vector<TOffset>& offsets) {
+            const std::size_t points = num_points(piece);
+            double cx = 0.0;
+            double cy = 0.0;
+            const bool split_x = points > m_max_points && depth < max_subdivision_depth &&
+                                 detail::split_value(piece.coords, stride(), 0, cx);
+            const bool split_y = points > m_max_points && depth < max_subdivision_depth &&
+                                 detail::split_value(piece.coords, stride(), 1, cy);
+            if (!split_x && !split_y) {
+                return write_piece(piece, batch, offsets);
+            }
+
+            std::size_t count = 0;
+            for (int sx = 0; sx < (split_x ? 2 : 1); ++sx) {
+                const detail::polygon_list* half = &piece;
+                if (split_x) {
+                    detail::clip_half_plane(piece, stride(), 0, cx, sx == 0, m_halves[depth], m_scratch);
+                    half = &m_halves[depth];
+                }
+                for (int sy = 0; sy < (split_y ? 2 : 1); ++sy) {
+                    const detail::polygon_list* quadrant = half;
+                    if (split_y) {
+                        detail::clip_half_plane(*half, stride(), 1, cy, sy == 0, m_quadrants[depth], m_scratch);
+                        quadrant = &m_quadrants[depth];
+                    }
+                    if (quadrant->polygon_ends.empty()) {
+                        continue;
+                    }
+                    // stop if the split did not help, e.g. for invalid input
+                    count += num_points(*quadrant) < points ? subdivide(*quadrant, depth + 1, batch, offsets)
+                                                            : write_piece(*quadrant, batch, offsets);
+                }
+            }
+            return count;
+        }
+
+    public:
+
+        /**
+         * @param max_points largest number of points of a polygon written
+         *        as it is, at least 5
+         */
+        Subdivider(TWriter& writer, std::size_t max_points) :
+            m_writer(writer),
+            m_max_points(max_points),
+            m_halves(max_subdivision_depth),
+            m_quadrants(max_subdivision_depth) {
+            if (max_points < 5) {
+                throw wkb_error{"Subdivided polygons need at least 5 points"};
+            }
+        }
+
+        TWriter& writer() noexcept {
+            return m_writer;
+        }
+
+        std::size_t max_points() const noexcept {
+            return m_max_points;
+        }
+
+        void multipolygon_start() {
+            m_open = false;
+            m_num_large = 0;
+        }
+
+        void multipolygon_polygon_start() {
+            m_current.clear();
+        }
+
+        void multipolygon_polygon_finish() {
+            if (m_current.ring_ends.empty()) {
+                return;
+            }
+            m_current.polygon_ends.push_back(m_current.ring_ends.size());
+            if (num_points(m_current) <= m_max_points) {
+                if (!m_open) {
+                    m_writer.multipolygon_start();
+                    m_open = true;
+                }
+                write_member(m_current, 0);
+                return;
+            }
+            if (m_num_large == m_large.size()) {
+                m_large.emplace_back();
+            }
+            // swap to keep the capacity of both buffers
+            std::swap(m_current, m_large[m_num_large]);
+            ++m_num_large;
+        }
+
+        void multipolygon_outer_ring_start() {
+        }
+
+        void multipolygon_outer_ring_finish() {
+            finish_ring();
+        }
+
+        void multipolygon_inner_ring_start() {
+        }
+
+        void multipolygon_inner_ring_finish() {
+            finish_ring();
+        }
+
+        /**
+         * Add a point of the current ring. Like with the writer, the
+         * number of coordinates must match its dimensions.
+         */
+        void multipolygon_add_location(const double x, const double y) {
+            const double coords[2] = {x, y};
+            add(coords, 2);
+        }
+
+        void multipolygon_add_location(const double x, const double y, const double c) {
+            const double coords[3] = {x, y, c};
+            add(coords, 3);
+        }
+
+        void multipolygon_add_location(const double x, const double y, const double z, const double m) {
+            const double coords[4] = {x, y, z, m};
+            add(coords, 4);
+        }
+
+        /**
+         * Add n points given as interleaved coordinates, see
+         * GenericWKBWriter::multipolygon_add_locations().
+         */
+        void multipolygon_add_locations(const double* coords, const std::size_t n) {
+            m_current.coords.insert(m_current.coords.end(), coords, coords + n * stride());
+        }
+
+        /**
+         * Append the results to batch: first the MultiPolygon of all
+         * polygons below the limit (if there are any), then one
+         * MultiPolygon for each piece of the larger polygons. offsets gets
+         * the end of each of them in batch; if it is empty, the start of
+         * the first one is added before (the layout of Arrow binary
+         * columns, like GenericWKBWriter::multipolygon_finish() in explode
+         * mode). Reusing batch and offsets for the next MultiPolygon after
+         * clearing them needs no allocations.
+         *
+         * @returns the number of geometries appended
+         */
+        template <typename TOffset>
+        std::size_t multipolygon_finish(std::string& batch, std::vector<TOffset>& offsets) {
+            if (offsets.empty()) {
+                offsets.push_back(static_cast<TOffset>(batch.size()));
+            }
+            std::size_t count = 0;
+            if (m_open) {
+                m_writer.multipolygon_finish(batch);
+                offsets.push_back(static_cast<TOffset>(batch.size()));
+                m_open = false;
+                ++count;
+            }
+            for (std::size_t i = 0; i < m_num_large; ++i) {
+                detail::orient_rings(m_large[i], stride());
+                count += subdivide(m_large[i], 0, batch, offsets);
+            }
+            m_num_large = 0;
+            return count;
+        }
+
+        /**
+         * Return the results as separate strings. Convenient, but each of
+         * them is allocated, see
+         * multipolygon_finish(std::string&, std::vector<TOffset>&).
+         */
+        std::vector<std::string> multipolygon_finish() {
+            std::string batch;
+            std::vector<std::size_t> offsets;
+            multipolygon_finish(batch, offsets);
+            std::vector<std::string> out;
+            out.reserve(offsets.size() - 1);
+            for (std::size_t i = 1; i < offsets.size(); ++i) {
+                out.emplace_back(batch, offsets[i - 1], offsets[i] - offsets[i - 1]);
+            }
+            return out;
+        }
+
+    }; // class Subdivider
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_SUBDIVIDE_HPP */
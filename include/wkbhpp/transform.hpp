@@ -0,0 +1,375 @@
+#ifndef WKBHPP_TRANSFORM_HPP
+#define WKBHPP_TRANSFORM_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/detail/endian.hpp>
+#include <wkbhpp/error.hpp>
+#include <wkbhpp/format.hpp>
+#include <wkbhpp/validate.hpp>
+#include <wkbhpp/wkbview.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace wkbhpp {
+
+    namespace detail {
+
+        inline void swap_uint32_inplace(char* data) noexcept {
+            uint32_t value;
+            std::memcpy(&value, data, sizeof(uint32_t));
+            value = byte_swap(value);
+            std::memcpy(data, &value, sizeof(uint32_t));
+        }
+
+        /**
+         * Read a count field and swap it in place if swap is set.
+         */
+        inline uint32_t convert_count(char* data, bool swap, bool swapped) noexcept {
+            const uint32_t count = read_value<uint32_t>(data, swapped);
+            if (swap) {
+                swap_uint32_inplace(data);
+            }
+            return count;
+        }
+
+        /**
+         * Call func(offset, header) for the header of every geometry nested
+         * in the valid geometry at data in the order they are stored.
+         */
+        template <typename TFunc>
+        inline void for_each_header(const char* data, std::size_t size, TFunc&& func) {
+            std::size_t offset = 0;
+            std::size_t pending = 1;
+            while (pending > 0) {
+                --pending;
+                wkb_header header;
+                decode_header(data + offset, size - offset, header);
+                func(offset, header);
+                offset += header.size;
+
+                if (header.type == geometry_type::point) {
+                    offset += header.point_size();
+                    continue;
+                }
+                const uint32_t count = read_value<uint32_t>(data + offset, header.swap());
+                if (header.type == geometry_type::linestring) {
+                    check_points(data, size, offset, header);
+                } else if (header.type == geometry_type::polygon) {
+                    offset += sizeof(uint32_t);
+                    for (uint32_t i = 0; i < count; ++i) {
+                        check_points(data, size, offset, header);
+                    }
+                } else {
+                    offset += sizeof(uint32_t);
+                    pending += count;
+                }
+            }
+        }
+
+        template <typename T>
+        inline void push_value(std::string& out, T value, bool swap) {
+            if (swap) {
+                value = byte_swap_value(value);
+            }
+            out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        /**
+         * Type field for the decoded header: with the ISO offsets for Z
+         * and M (1000, 2000, 3000) in WKB and with the Z, M and SRID flags
+         * in EWKB, like WKBWriter writes them.
+         */
+        inline uint32_t encode_type(const wkb_header& header, wkb_type wtype) noexcept {
+            const uint32_t type = static_cast<uint32_t>(header.type);
+            if (wtype == wkb_type::ewkb) {
+                return type | ewkb_srid_flag | (header.has_z ? ewkb_z_flag : 0u) | (header.has_m ? ewkb_m_flag : 0u);
+            }
+            return type + (header.has_z ? 1000u : 0u) + (header.has_m ? 2000u : 0u);
+        }
+
+        /**
+         * Append the valid geometry of the given size at data to out,
+         * rewriting every header for wtype: the type field with the
+         * dimensions in that flavour, and the SRID added or removed.
+         * Everything between the headers is copied as is.
+         */
+        inline void append_with_srid(std::string& out, const char* data, std::size_t size, wkb_type wtype, int srid) {
+            std::size_t copied = 0;
+            for_each_header(data, size, [&](std::size_t offset, const wkb_header& header) {
+                out.append(data + copied, offset - copied);
+                out += data[offset];
+                push_value(out, encode_type(header, wtype), header.swap());
+                if (wtype == wkb_type::ewkb) {
+                    push_value(out, static_cast<int32_t>(srid), header.swap());
+                }
+                copied = offset + header.size;
+            });
+            out.append(data + copied, size - copied);
+        }
+
+        /**
+         * Set the SRID in all headers of the valid geometry at data which
+         * have one.
+         *
+         * @returns false if the outermost geometry has no SRID
+         */
+        inline bool rewrite_srid(char* data, std::size_t size, int srid) {
+            bool found = false;
+            for_each_header(data, size, [data, srid, &found](std::size_t offset, const wkb_header& header) {
+                if (offset == 0) {
+                    found = header.has_srid;
+                }
+                if (header.has_srid) {
+                    int32_t value = static_cast<int32_t>(srid);
+                    if (header.swap()) {
+                        value = byte_swap_value(value);
+                    }
+                    std::memcpy(data + offset + 1 + sizeof(uint32_t), &value, sizeof(int32_t));
+                }
+            });
+            return found;
+        }
+
+    } // namespace detail
+
+    /**
+     * Convert the WKB or EWKB geometry at the start of the buffer to the
+     * given byte order in place. Byte order markers, types, SRIDs, counts
+     * and coordinates of all nested geometries which are not in that byte
+     * order already are swapped, coordinates with SIMD instructions if the
+     * CPU supports them.
+     *
+     * The geometry is validated before anything is changed, invalid input
+     * is left untouched.
+     *
+     * @returns size of the geometry in bytes
+     * @throws wkb_error if the geometry is invalid or truncated
+     */
+    inline std::size_t set_byte_order(char* data, std::size_t size, byte_order order) {
+        std::size_t end = 0;
+        detail::check(detail::check_geometry(data, size, end));
+
+        std::size_t offset = 0;
+        std::size_t pending = 1;
+        while (pending > 0) {
+            --pending;
+            detail::wkb_header header;
+            detail::decode_header(data + offset, size - offset, header);
+            char* const geometry = data + offset;
+            const bool swapped = header.swap();
+            const bool swap = header.order != order;
+            if (swap) {
+                geometry[0] = static_cast<char>(order);
+                detail::swap_uint32_inplace(geometry + 1);
+                if (header.has_srid) {
+                    detail::swap_uint32_inplace(geometry + 1 + sizeof(uint32_t));
+                }
+            }
+            offset += header.size;
+
+            const std::size_t values_per_point = header.point_size() / sizeof(double);
+            const auto convert_points = [&](uint32_t count) {
+                if (swap) {
+                    detail::byte_swap_doubles(data + offset, data + offset, count * values_per_point);
+                }
+                offset += count * header.point_size();
+            };
+
+            if (header.type == geometry_type::point) {
+                convert_points(1);
+                continue;
+            }
+            const uint32_t count = detail::convert_count(data + offset, swap, swapped);
+            offset += sizeof(uint32_t);
+            if (header.type == geometry_type::linestring) {
+                convert_points(count);
+            } else if (header.type == geometry_type::polygon) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    const uint32_t points = detail::convert_count(data + offset, swap, swapped);
+                    offset += sizeof(uint32_t);
+                    convert_points(points);
+                }
+            } else {
+                pending += count;
+            }
+        }
+
+        return end;
+    }
+
+    /**
+     * Convert a binary WKB geometry in a string to the given byte order in
+     * place.
+     *
+     * @throws wkb_error if the geometry is invalid or truncated
+     */
+    inline void set_byte_order(std::string& wkb, byte_order order) {
+        set_byte_order(&wkb[0], wkb.size(), order);
+    }
+
+    /**
+     * Append the WKB or EWKB geometry at the start of the buffer to out as
+     * plain WKB (wkb_type::wkb) or as EWKB with the given SRID
+     * (wkb_type::ewkb). Like WKBWriter, the SRID is written into the
+     * headers of all nested geometries and Z and M are marked with the
+     * ISO type codes in WKB and with flags in EWKB. Only the headers are
+     * rewritten,
+     * counts and coordinates are copied without decoding them.
+     *
+     * @returns size of the input geometry in bytes
+     * @throws wkb_error if the geometry is invalid or truncated
+     */
+    inline std::size_t append_as(std::string& out, const char* data, std::size_t size, wkb_type wtype, int srid = 0) {
+        std::size_t end = 0;
+        detail::check(detail::check_geometry(data, size, end));
+        detail::append_with_srid(out, data, end, wtype, srid);
+        return end;
+    }
+
+    /**
+     * Convert a binary WKB or EWKB geometry to plain WKB.
+     *
+     * @throws wkb_error if the geometry is invalid or truncated
+     */
+    inline std::string convert_to_wkb(const std::string& wkb) {
+        std::string out;
+        out.reserve(wkb.size());
+        append_as(out, wkb.data(), wkb.size(), wkb_type::wkb);
+        return out;
+    }
+
+    /**
+     * Convert a binary WKB or EWKB geometry to EWKB with the given SRID.
+     *
+     * @throws wkb_error if the geometry is invalid or truncated
+     */
+    inline std::string convert_to_ewkb(const std::string& wkb, int srid) {
+        std::string out;
+        out.reserve(wkb.size() + 2 * sizeof(int32_t));
+        append_as(out, wkb.data(), wkb.size(), wkb_type::ewkb, srid);
+        return out;
+    }
+
+    /**
+     * Replace the SRID in all headers of the EWKB geometry at the start of
+     * the buffer which have one. Nothing changes size, so this is done in
+     * place.
+     *
+     * @returns size of the geometry in bytes
+     * @throws wkb_error if the geometry is invalid, truncated or has no
+     *         SRID (use append_as() to add one)
+     */
+    inline std::size_t set_srid(char* data, std::size_t size, int srid) {
+        std::size_t end = 0;
+        detail::check(detail::check_geometry(data, size, end));
+        if (!detail::rewrite_srid(data, end, srid)) {
+            throw wkb_error{"WKB geometry has no SRID"};
+        }
+        return end;
+    }
+
+    /**
+     * Replace the SRID of a binary EWKB geometry in a string in place.
+     *
+     * @throws wkb_error if the geometry is invalid, truncated or has no
+     *         SRID
+     */
+    inline void set_srid(std::string& ewkb, int srid) {
+        set_srid(&ewkb[0], ewkb.size(), srid);
+    }
+
+    /**
+     * Convert a column of count geometries to WKB or EWKB with the given
+     * SRID and append them to out_data and out_offsets. Geometry i
+     * occupies the bytes from offsets[i] to offsets[i + 1] of data (the
+     * layout of Arrow binary columns). The output has the same layout:
+     * out_offsets gets the end of each converted geometry in out_data,
+     * preceded by the current size of out_data if out_offsets is empty.
+     * Like the single geometry version this appends, so several columns
+     * can be collected in one buffer.
+     *
+     * @throws wkb_error if a geometry is invalid, the outputs are left
+     *         as they were
+     */
+    template <typename TOffset>
+    void append_as(std::string& out_data, std::vector<TOffset>& out_offsets,
+                   const char* data, const TOffset* offsets, std::size_t count,
+                   wkb_type wtype, int srid = 0) {
+        const std::size_t old_size = out_data.size();
+        const std::size_t old_offsets = out_offsets.size();
+        out_data.reserve(old_size + static_cast<std::size_t>(offsets[count] - offsets[0]));
+        out_offsets.reserve(old_offsets + count + 1);
+        if (out_offsets.empty()) {
+            out_offsets.push_back(static_cast<TOffset>(old_size));
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            const char* geometry = data + offsets[i];
+            const std::size_t size = static_cast<std::size_t>(offsets[i + 1] - offsets[i]);
+            if (offsets[i + 1] < offsets[i] || validate(geometry, size) != wkb_status::ok) {
+                out_data.resize(old_size);
+                out_offsets.resize(old_offsets);
+                throw wkb_error{"Invalid WKB geometry in row " + std::to_string(i)};
+            }
+            detail::append_with_srid(out_data, geometry, size, wtype, srid);
+            out_offsets.push_back(static_cast<TOffset>(out_data.size()));
+        }
+    }
+
+    /**
+     * Replace the SRIDs of a column of EWKB geometries in place, see
+     * set_srid() and append_as() for the layout of the column.
+     *
+     * @throws wkb_error if a geometry is invalid or has no SRID, the rows
+     *         before it have been changed already
+     */
+    template <typename TOffset>
+    void set_srid(char* data, const TOffset* offsets, std::size_t count, int srid) {
+        for (std::size_t i = 0; i < count; ++i) {
+            char* geometry = data + offsets[i];
+            const std::size_t size = static_cast<std::size_t>(offsets[i + 1] - offsets[i]);
+            if (offsets[i + 1] < offsets[i] || validate(geometry, size) != wkb_status::ok ||
+                !detail::rewrite_srid(geometry, size, srid)) {
+                throw wkb_error{"Invalid WKB geometry in row " + std::to_string(i)};
+            }
+        }
+    }
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_TRANSFORM_HPP */
@@ -0,0 +1,313 @@
+#ifndef WKBHPP_VALIDATE_HPP
+#define WKBHPP_VALIDATE_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/detail/endian.hpp>
+#include <wkbhpp/format.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace wkbhpp {
+
+    /**
+     * Result of the structural validation of a WKB geometry.
+     */
+    enum class wkb_status : uint8_t {
+        ok                 = 0,
+        truncated          = 1, // counts or coordinates beyond the end of the input
+        invalid_byte_order = 2, // byte order marker is neither 0 nor 1
+        unknown_type       = 3,
+        invalid_member     = 4, // e.g. a LineString inside a MultiPoint
+        nested_too_deeply  = 5, // more than max_collection_depth levels
+        trailing_bytes     = 6  // input continues after the geometry
+    }; // enum class wkb_status
+
+    namespace detail {
+
+        // flags in the type field of EWKB
+        constexpr const uint32_t ewkb_z_flag = 0x80000000;
+        constexpr const uint32_t ewkb_m_flag = 0x40000000;
+        constexpr const uint32_t ewkb_srid_flag = 0x20000000;
+
+        /**
+         * Read a value of type T from unaligned memory, reversing its bytes
+         * if swap is set.
+         */
+        template <typename T>
+        inline T read_value(const char* data, bool swap) noexcept {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            return swap ? byte_swap_value(value) : value;
+        }
+
+        /**
+         * Decoded header of a WKB geometry: byte order marker, type and
+         * optional SRID.
+         */
+        struct wkb_header {
+            geometry_type type = geometry_type::point;
+            byte_order order = native_byte_order;
+            bool has_z = false;
+            bool has_m = false;
+            bool has_srid = false;
+            int32_t srid = 0;
+
+            // size of the header in bytes
+            std::size_t size = 0;
+
+            bool swap() const noexcept {
+                return order != native_byte_order;
+            }
+
+            // size of a point in bytes
+            std::size_t point_size() const noexcept {
+                return (2 + has_z + has_m) * sizeof(double);
+            }
+        };
+
+        /**
+         * Decode the type field of a geometry. Both the ISO type codes
+         * (1000 + type for Z, 2000 + type for M, 3000 + type for ZM) and the
+         * EWKB flags are understood.
+         *
+         * @returns false if the type is unknown
+         */
+        inline bool decode_type(uint32_t raw, wkb_header& header) noexcept {
+            header.has_z = (raw & ewkb_z_flag) != 0;
+            header.has_m = (raw & ewkb_m_flag) != 0;
+            header.has_srid = (raw & ewkb_srid_flag) != 0;
+            raw &= ~(ewkb_z_flag | ewkb_m_flag | ewkb_srid_flag);
+            // common case: 2D type codes without ISO dimensions
+            if (raw - 1 < static_cast<uint32_t>(geometry_type::geometrycollection)) {
+                header.type = static_cast<geometry_type>(raw);
+                return true;
+            }
+            switch (raw / 1000) {
+                case 0:
+                    break;
+                case 1:
+                    header.has_z = true;
+                    break;
+                case 2:
+                    header.has_m = true;
+                    break;
+                case 3:
+                    header.has_z = true;
+                    header.has_m = true;
+                    break;
+                default:
+                    return false;
+            }
+            raw %= 1000;
+            if (raw < static_cast<uint32_t>(geometry_type::point) ||
+                raw > static_cast<uint32_t>(geometry_type::geometrycollection)) {
+                return false;
+            }
+            header.type = static_cast<geometry_type>(raw);
+            return true;
+        }
+
+        /**
+         * Decode the header of the geometry at data into header.
+         */
+        inline wkb_status decode_header(const char* data, std::size_t size, wkb_header& header) noexcept {
+            if (size < 1 + sizeof(uint32_t)) {
+                return wkb_status::truncated;
+            }
+            if (data[0] != 0 && data[0] != 1) {
+                return wkb_status::invalid_byte_order;
+            }
+            header.order = static_cast<byte_order>(data[0]);
+            if (!decode_type(read_value<uint32_t>(data + 1, header.swap()), header)) {
+                return wkb_status::unknown_type;
+            }
+            header.size = 1 + sizeof(uint32_t);
+            if (header.has_srid) {
+                if (size < header.size + sizeof(int32_t)) {
+                    return wkb_status::truncated;
+                }
+                header.srid = read_value<int32_t>(data + header.size, header.swap());
+                header.size += sizeof(int32_t);
+            }
+            return wkb_status::ok;
+        }
+
+        /**
+         * Read a count field at offset and check that count elements of at
+         * least min_size bytes each fit into size. The comparison is done
+         * by division so that it cannot overflow.
+         */
+        inline wkb_status read_count(const char* data, std::size_t size, std::size_t& offset, const wkb_header& header,
+                                     std::size_t min_size, uint32_t& count) noexcept {
+            if (size - offset < sizeof(uint32_t)) {
+                return wkb_status::truncated;
+            }
+            count = read_value<uint32_t>(data + offset, header.swap());
+            offset += sizeof(uint32_t);
+            if (count > (size - offset) / min_size) {
+                return wkb_status::truncated;
+            }
+            return wkb_status::ok;
+        }
+
+        /**
+         * Check the points of a linestring or ring at offset and move offset
+         * behind them.
+         */
+        inline wkb_status check_points(const char* data, std::size_t size, std::size_t& offset, const wkb_header& header) noexcept {
+            uint32_t count = 0;
+            const wkb_status status = read_count(data, size, offset, header, header.point_size(), count);
+            if (status == wkb_status::ok) {
+                offset += count * header.point_size();
+            }
+            return status;
+        }
+
+        /**
+         * Check the structure of the geometry at offset and move offset
+         * behind it. Only headers and count fields are read, coordinates
+         * are skipped. Nested geometries are tracked on a fixed size stack.
+         */
+        inline wkb_status check_geometry(const char* data, std::size_t size, std::size_t& offset) noexcept {
+            struct frame {
+                geometry_type type;
+                uint32_t remaining;
+            };
+
+            // open multi geometries and collections
+            std::array<frame, max_collection_depth> stack;
+            std::size_t depth = 0;
+
+            // smallest possible geometry: byte order, type and a count
+            constexpr const std::size_t min_geometry_size = 1 + 2 * sizeof(uint32_t);
+
+            do {
+                wkb_header header;
+                wkb_status status = decode_header(data + offset, size - offset, header);
+                if (status != wkb_status::ok) {
+                    return status;
+                }
+                offset += header.size;
+
+                if (depth > 0) {
+                    const geometry_type parent = stack[depth - 1].type;
+                    --stack[depth - 1].remaining;
+                    if (parent != geometry_type::geometrycollection &&
+                        static_cast<uint32_t>(parent) != static_cast<uint32_t>(header.type) + 3) {
+                        return wkb_status::invalid_member;
+                    }
+                }
+
+                uint32_t count = 0;
+                switch (header.type) {
+                    case geometry_type::point:
+                        if (size - offset < header.point_size()) {
+                            return wkb_status::truncated;
+                        }
+                        offset += header.point_size();
+                        break;
+                    case geometry_type::linestring:
+                        status = check_points(data, size, offset, header);
+                        break;
+                    case geometry_type::polygon:
+                        status = read_count(data, size, offset, header, sizeof(uint32_t), count);
+                        for (uint32_t i = 0; i < count && status == wkb_status::ok; ++i) {
+                            status = check_points(data, size, offset, header);
+                        }
+                        break;
+                    default:
+                        status = read_count(data, size, offset, header, min_geometry_size, count);
+                        if (depth == max_collection_depth) {
+                            return wkb_status::nested_too_deeply;
+                        }
+                        stack[depth] = frame{header.type, count};
+                        ++depth;
+                }
+                if (status != wkb_status::ok) {
+                    return status;
+                }
+
+                while (depth > 0 && stack[depth - 1].remaining == 0) {
+                    --depth;
+                }
+            } while (depth > 0);
+
+            return wkb_status::ok;
+        }
+
+    } // namespace detail
+
+    /**
+     * Check the structure of a WKB or EWKB geometry without decoding it:
+     * byte order markers, type codes, SRIDs and count fields must be
+     * valid and fit exactly into size bytes. Coordinates are not looked
+     * at.
+     */
+    inline wkb_status validate(const char* data, std::size_t size) noexcept {
+        std::size_t offset = 0;
+        const wkb_status status = detail::check_geometry(data, size, offset);
+        if (status != wkb_status::ok) {
+            return status;
+        }
+        return offset == size ? wkb_status::ok : wkb_status::trailing_bytes;
+    }
+
+    /**
+     * Validate a column of count WKB geometries stored back to back in
+     * data. Geometry i occupies the bytes from offsets[i] to
+     * offsets[i + 1], i.e. offsets has count + 1 entries (the layout of
+     * Arrow binary columns).
+     *
+     * @returns indices of the invalid geometries
+     */
+    template <typename TOffset>
+    std::vector<std::size_t> validate(const char* data, const TOffset* offsets, std::size_t count) {
+        std::vector<std::size_t> invalid;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (offsets[i + 1] < offsets[i] ||
+                validate(data + offsets[i], static_cast<std::size_t>(offsets[i + 1] - offsets[i])) != wkb_status::ok) {
+                invalid.push_back(i);
+            }
+        }
+        return invalid;
+    }
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_VALIDATE_HPP */
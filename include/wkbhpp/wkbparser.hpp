@@ -0,0 +1,572 @@
+#ifndef WKBHPP_WKBPARSER_HPP
+#define WKBHPP_WKBPARSER_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/error.hpp>
+#include <wkbhpp/format.hpp>
+#include <wkbhpp/point_traits.hpp>
+#include <wkbhpp/validate.hpp>
+#include <wkbhpp/wkbview.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace wkbhpp {
+
+    namespace detail {
+
+        // Passed instead of an output to call the finish methods without
+        // one.
+        struct no_output {
+        };
+
+        // Tags selecting the handler method which gets the coordinates of
+        // a point, see add_coordinates().
+        struct make_point_call {};
+        struct linestring_call {};
+        struct polygon_call {};
+        struct multipolygon_call {};
+        struct multipoint_call {};
+        struct multilinestring_call {};
+        struct geometrycollection_call {};
+
+        template <typename THandler, typename... TArgs>
+        auto call(make_point_call, THandler& handler, TArgs&... args) -> decltype(handler.make_point(args...)) {
+            return handler.make_point(args...);
+        }
+
+        template <typename THandler, typename... TArgs>
+        auto call(linestring_call, THandler& handler, TArgs&... args) -> decltype(handler.linestring_add_location(args...)) {
+            return handler.linestring_add_location(args...);
+        }
+
+        template <typename THandler, typename... TArgs>
+        auto call(polygon_call, THandler& handler, TArgs&... args) -> decltype(handler.polygon_add_location(args...)) {
+            return handler.polygon_add_location(args...);
+        }
+
+        template <typename THandler, typename... TArgs>
+        auto call(multipolygon_call, THandler& handler, TArgs&... args) -> decltype(handler.multipolygon_add_location(args...)) {
+            return handler.multipolygon_add_location(args...);
+        }
+
+        template <typename THandler, typename... TArgs>
+        auto call(multipoint_call, THandler& handler, TArgs&... args) -> decltype(handler.multipoint_add_location(args...)) {
+            return handler.multipoint_add_location(args...);
+        }
+
+        template <typename THandler, typename... TArgs>
+        auto call(multilinestring_call, THandler& handler, TArgs&... args) -> decltype(handler.multilinestring_add_location(args...)) {
+            return handler.multilinestring_add_location(args...);
+        }
+
+        template <typename THandler, typename... TArgs>
+        auto call(geometrycollection_call, THandler& handler, TArgs&... args) -> decltype(handler.geometrycollection_add_point(args...)) {
+            return handler.geometrycollection_add_point(args...);
+        }
+
+        /**
+         * Call the handler method selected by TCall with the n (2 to 4)
+         * coordinates in c, followed by rest. Used if the handler has the
+         * methods for 3 and 4 coordinates.
+         */
+        template <typename TCall, typename THandler, typename... TRest>
+        auto add_coordinates(int /*preferred*/, THandler& handler, const double* c, std::size_t n, TRest&... rest)
+            -> decltype(call(TCall{}, handler, c[0], c[1], c[2], rest...),
+                        call(TCall{}, handler, c[0], c[1], c[2], c[3], rest...), void()) {
+            switch (n) {
+                case 2:
+                    call(TCall{}, handler, c[0], c[1], rest...);
+                    break;
+                case 3:
+                    call(TCall{}, handler, c[0], c[1], c[2], rest...);
+                    break;
+                default:
+                    call(TCall{}, handler, c[0], c[1], c[2], c[3], rest...);
+            }
+        }
+
+        /**
+         * Handlers without methods for 3 and 4 coordinates only get X and
+         * Y.
+         */
+        template <typename TCall, typename THandler, typename... TRest>
+        void add_coordinates(long /*fallback*/, THandler& handler, const double* c, std::size_t /*n*/, TRest&... rest) {
+            call(TCall{}, handler, c[0], c[1], rest...);
+        }
+
+        /**
+         * Read the coordinates of the point at data into c.
+         *
+         * @returns the number of coordinates
+         */
+        inline std::size_t read_coordinates(const char* data, const wkb_header& header, double* c) noexcept {
+            const std::size_t n = header.point_size() / sizeof(double);
+            for (std::size_t i = 0; i < n; ++i) {
+                c[i] = read_value<double>(data + i * sizeof(double), header.swap());
+            }
+            return n;
+        }
+
+        template <typename THandler>
+        inline void finish_point(THandler& handler, const double* c, std::size_t n, no_output& /*out*/) {
+            add_coordinates<make_point_call>(0, handler, c, n);
+        }
+
+        template <typename THandler, typename TOut>
+        inline void finish_point(THandler& handler, const double* c, std::size_t n, TOut& out) {
+            add_coordinates<make_point_call>(0, handler, c, n, out);
+        }
+
+        template <typename THandler>
+        inline void finish_linestring(THandler& handler, std::size_t num_points, no_output& /*out*/) {
+            handler.linestring_finish(num_points);
+        }
+
+        template <typename THandler, typename TOut>
+        inline void finish_linestring(THandler& handler, std::size_t num_points, TOut& out) {
+            handler.linestring_finish(num_points, out);
+        }
+
+        template <typename THandler>
+        inline void finish_polygon(THandler& handler, no_output& /*out*/) {
+            handler.polygon_finish();
+        }
+
+        template <typename THandler, typename TOut>
+        inline void finish_polygon(THandler& handler, TOut& out) {
+            handler.polygon_finish(out);
+        }
+
+        template <typename THandler>
+        inline void finish_multipolygon(THandler& handler, no_output& /*out*/) {
+            handler.multipolygon_finish();
+        }
+
+        template <typename THandler, typename TOut>
+        inline void finish_multipolygon(THandler& handler, TOut& out) {
+            handler.multipolygon_finish(out);
+        }
+
+        template <typename THandler, typename = void>
+        struct has_multipoint : std::false_type {
+        };
+
+        template <typename THandler>
+        struct has_multipoint<THandler, void_t<decltype(std::declval<THandler&>().multipoint_start())>> : std::true_type {
+        };
+
+        template <typename THandler, typename = void>
+        struct has_multilinestring : std::false_type {
+        };
+
+        template <typename THandler>
+        struct has_multilinestring<THandler, void_t<decltype(std::declval<THandler&>().multilinestring_start())>> : std::true_type {
+        };
+
+        template <typename THandler, typename = void>
+        struct has_geometrycollection : std::false_type {
+        };
+
+        template <typename THandler>
+        struct has_geometrycollection<THandler, void_t<decltype(std::declval<THandler&>().geometrycollection_start())>> : std::true_type {
+        };
+
+        /**
+         * Calls for MultiPoints. Handlers without multipoint_start() do not
+         * support them, parsing one throws.
+         */
+        template <typename THandler, bool = has_multipoint<THandler>::value>
+        struct multipoint_calls {
+
+            static void start(THandler& handler) {
+                handler.multipoint_start();
+            }
+
+            static void add_location(THandler& handler, const double* c, std::size_t n) {
+                add_coordinates<multipoint_call>(0, handler, c, n);
+            }
+
+            static void finish(THandler& handler, no_output& /*out*/) {
+                handler.multipoint_finish();
+            }
+
+            template <typename TOut>
+            static void finish(THandler& handler, TOut& out) {
+                handler.multipoint_finish(out);
+            }
+
+        }; // struct multipoint_calls
+
+        template <typename THandler>
+        struct multipoint_calls<THandler, false> {
+
+            static void start(THandler& /*handler*/) {
+                throw wkb_error{"Handler does not support MultiPoint"};
+            }
+
+            static void add_location(THandler& /*handler*/, const double* /*c*/, std::size_t /*n*/) {
+            }
+
+            template <typename TOut>
+            static void finish(THandler& /*handler*/, TOut& /*out*/) {
+            }
+
+        }; // struct multipoint_calls
+
+        template <typename THandler, bool = has_multilinestring<THandler>::value>
+        struct multilinestring_calls {
+
+            static void start(THandler& handler) {
+                handler.multilinestring_start();
+            }
+
+            static void linestring_start(THandler& handler) {
+                handler.multilinestring_linestring_start();
+            }
+
+            static void add_location(THandler& handler, const double* c, std::size_t n) {
+                add_coordinates<multilinestring_call>(0, handler, c, n);
+            }
+
+            static void linestring_finish(THandler& handler) {
+                handler.multilinestring_linestring_finish();
+            }
+
+            static void finish(THandler& handler, no_output& /*out*/) {
+                handler.multilinestring_finish();
+            }
+
+            template <typename TOut>
+            static void finish(THandler& handler, TOut& out) {
+                handler.multilinestring_finish(out);
+            }
+
+        }; // struct multilinestring_calls
+
+        template <typename THandler>
+        struct multilinestring_calls<THandler, false> {
+
+            static void start(THandler& /*handler*/) {
+                throw wkb_error{"Handler does not support MultiLineString"};
+            }
+
+            static void linestring_start(THandler& /*handler*/) {
+            }
+
+            static void add_location(THandler& /*handler*/, const double* /*c*/, std::size_t /*n*/) {
+            }
+
+            static void linestring_finish(THandler& /*handler*/) {
+            }
+
+            template <typename TOut>
+            static void finish(THandler& /*handler*/, TOut& /*out*/) {
+            }
+
+        }; // struct multilinestring_calls
+
+        template <typename THandler, bool = has_geometrycollection<THandler>::value>
+        struct geometrycollection_calls {
+
+            static void start(THandler& handler) {
+                handler.geometrycollection_start();
+            }
+
+            static void add_point(THandler& handler, const double* c, std::size_t n) {
+                add_coordinates<geometrycollection_call>(0, handler, c, n);
+            }
+
+            static void finish(THandler& handler, no_output& /*out*/) {
+                handler.geometrycollection_finish();
+            }
+
+            template <typename TOut>
+            static void finish(THandler& handler, TOut& out) {
+                handler.geometrycollection_finish(out);
+            }
+
+        }; // struct geometrycollection_calls
+
+        template <typename THandler>
+        struct geometrycollection_calls<THandler, false> {
+
+            static void start(THandler& /*handler*/) {
+                throw wkb_error{"Handler does not support GeometryCollection"};
+            }
+
+            static void add_point(THandler& /*handler*/, const double* /*c*/, std::size_t /*n*/) {
+            }
+
+            template <typename TOut>
+            static void finish(THandler& /*handler*/, TOut& /*out*/) {
+            }
+
+        }; // struct geometrycollection_calls
+
+        /**
+         * Reads the points of a linestring or ring and calls add with the
+         * coordinates and their number (2 to 4) for each of them.
+         *
+         * @returns number of points
+         */
+        template <typename TAdd>
+        inline uint32_t parse_points(const char* data, std::size_t size, std::size_t& offset, const wkb_header& header, TAdd&& add) {
+            const std::size_t end = skip_points(data, size, offset, header);
+            const uint32_t count = read_value<uint32_t>(data + offset, header.swap());
+            const char* point = data + offset + sizeof(uint32_t);
+            double c[4];
+            for (uint32_t i = 0; i < count; ++i, point += header.point_size()) {
+                add(c, read_coordinates(point, header, c));
+            }
+            offset = end;
+            return count;
+        }
+
+        inline uint32_t parse_count(const char* data, std::size_t size, std::size_t& offset, const wkb_header& header) {
+            if (size - offset < sizeof(uint32_t)) {
+                check(wkb_status::truncated);
+            }
+            const uint32_t count = read_value<uint32_t>(data + offset, header.swap());
+            offset += sizeof(uint32_t);
+            return count;
+        }
+
+        template <typename THandler, typename TOut>
+        std::size_t parse(const char* data, const std::size_t size, THandler& handler, TOut& out) {
+            using multipoint = multipoint_calls<THandler>;
+            using multilinestring = multilinestring_calls<THandler>;
+            using geometrycollection = geometrycollection_calls<THandler>;
+
+            struct frame {
+                geometry_type type;
+                uint32_t remaining;
+            };
+
+            // open multi geometries and collections
+            std::array<frame, max_collection_depth> stack;
+            std::size_t depth = 0;
+
+            no_output none;
+            std::size_t offset = 0;
+
+            do {
+                const wkb_header header = read_header(data + offset, size - offset);
+                offset += header.size;
+
+                const bool top = depth == 0;
+                const geometry_type parent = top ? geometry_type::geometrycollection : stack[depth - 1].type;
+                if (!top) {
+                    --stack[depth - 1].remaining;
+                    if (parent != geometry_type::geometrycollection &&
+                        static_cast<uint32_t>(parent) != static_cast<uint32_t>(header.type) + 3) {
+                        check(wkb_status::invalid_member);
+                    }
+                }
+
+                switch (header.type) {
+                    case geometry_type::point: {
+                        if (size - offset < header.point_size()) {
+                            check(wkb_status::truncated);
+                        }
+                        double c[4];
+                        const std::size_t n = read_coordinates(data + offset, header, c);
+                        offset += header.point_size();
+                        if (parent == geometry_type::multipoint) {
+                            multipoint::add_location(handler, c, n);
+                        } else if (top) {
+                            finish_point(handler, c, n, out);
+                        } else {
+                            geometrycollection::add_point(handler, c, n);
+                        }
+                        break;
+                    }
+                    case geometry_type::linestring:
+                        if (parent == geometry_type::multilinestring) {
+                            multilinestring::linestring_start(handler);
+                            parse_points(data, size, offset, header, [&handler](const double* c, std::size_t n) {
+                                multilinestring::add_location(handler, c, n);
+                            });
+                            multilinestring::linestring_finish(handler);
+                        } else {
+                            handler.linestring_start();
+                            const uint32_t count = parse_points(data, size, offset, header, [&handler](const double* c, std::size_t n) {
+                                add_coordinates<linestring_call>(0, handler, c, n);
+                            });
+                            if (top) {
+                                finish_linestring(handler, count, out);
+                            } else {
+                                finish_linestring(handler, count, none);
+                            }
+                        }
+                        break;
+                    case geometry_type::polygon: {
+                        const uint32_t rings = parse_count(data, size, offset, header);
+                        if (parent == geometry_type::multipolygon) {
+                            handler.multipolygon_polygon_start();
+                            for (uint32_t i = 0; i < rings; ++i) {
+                                if (i == 0) {
+                                    handler.multipolygon_outer_ring_start();
+                                } else {
+                                    handler.multipolygon_inner_ring_start();
+                                }
+                                parse_points(data, size, offset, header, [&handler](const double* c, std::size_t n) {
+                                    add_coordinates<multipolygon_call>(0, handler, c, n);
+                                });
+                                if (i == 0) {
+                                    handler.multipolygon_outer_ring_finish();
+                                } else {
+                                    handler.multipolygon_inner_ring_finish();
+                                }
+                            }
+                            handler.multipolygon_polygon_finish();
+                        } else {
+                            handler.polygon_start();
+                            for (uint32_t i = 0; i < rings; ++i) {
+                                if (i == 0) {
+                                    handler.polygon_outer_ring_start();
+                                } else {
+                                    handler.polygon_inner_ring_start();
+                                }
+                                parse_points(data, size, offset, header, [&handler](const double* c, std::size_t n) {
+                                    add_coordinates<polygon_call>(0, handler, c, n);
+                                });
+                                if (i == 0) {
+                                    handler.polygon_outer_ring_finish();
+                                } else {
+                                    handler.polygon_inner_ring_finish();
+                                }
+                            }
+                            if (top) {
+                                finish_polygon(handler, out);
+                            } else {
+                                finish_polygon(handler, none);
+                            }
+                        }
+                        break;
+                    }
+                    default: {
+                        const uint32_t count = parse_count(data, size, offset, header);
+                        if (depth == max_collection_depth) {
+                            check(wkb_status::nested_too_deeply);
+                        }
+                        if (header.type == geometry_type::multipoint) {
+                            multipoint::start(handler);
+                        } else if (header.type == geometry_type::multilinestring) {
+                            multilinestring::start(handler);
+                        } else if (header.type == geometry_type::multipolygon) {
+                            handler.multipolygon_start();
+                        } else {
+                            geometrycollection::start(handler);
+                        }
+                        stack[depth] = frame{header.type, count};
+                        ++depth;
+                    }
+                }
+
+                // finish all multi geometries and collections whose last
+                // member has been read
+                while (depth > 0 && stack[depth - 1].remaining == 0) {
+                    --depth;
+                    const geometry_type type = stack[depth].type;
+                    if (type == geometry_type::multipoint) {
+                        depth == 0 ? multipoint::finish(handler, out) : multipoint::finish(handler, none);
+                    } else if (type == geometry_type::multilinestring) {
+                        depth == 0 ? multilinestring::finish(handler, out) : multilinestring::finish(handler, none);
+                    } else if (type == geometry_type::multipolygon) {
+                        depth == 0 ? finish_multipolygon(handler, out) : finish_multipolygon(handler, none);
+                    } else {
+                        depth == 0 ? geometrycollection::finish(handler, out) : geometrycollection::finish(handler, none);
+                    }
+                }
+            } while (depth > 0);
+
+            return offset;
+        }
+
+    } // namespace detail
+
+    /**
+     * Parse the WKB or EWKB geometry at the start of the buffer and call
+     * the methods of the handler which WKBWriter has for writing the same
+     * geometry: linestring_start(), linestring_add_location(x, y),
+     * linestring_finish(num_points), multipolygon_polygon_start() and so
+     * on. Points are reported with make_point(x, y). A WKBWriter can be
+     * passed as handler to re-encode a geometry in a single pass.
+     *
+     * Geometries with Z and/or M values are reported with the methods
+     * taking 3 (x, y, z or m) or 4 (x, y, z, m) coordinates, e.g.
+     * linestring_add_location(x, y, z). Handlers which do not have these
+     * overloads only get X and Y.
+     *
+     * The finish method of the outermost geometry is called with out as
+     * additional argument, all other finish methods are called without
+     * one.
+     *
+     * MultiPoints, MultiLineStrings and GeometryCollections are only
+     * supported if the handler has multipoint_start(),
+     * multilinestring_start() or geometrycollection_start() respectively.
+     * Their members are reported with multipoint_add_location(),
+     * multilinestring_linestring_start(), multilinestring_add_location(),
+     * multilinestring_linestring_finish() and, for GeometryCollections,
+     * geometrycollection_add_point() and the methods of the member types.
+     *
+     * The parser does not recurse, GeometryCollections may be nested up to
+     * max_collection_depth levels. SRIDs are not reported.
+     *
+     * @returns number of bytes read
+     * @throws wkb_error if the input is invalid or not supported by the
+     *         handler
+     */
+    template <typename THandler, typename TOut>
+    std::size_t parse(const char* data, std::size_t size, THandler& handler, TOut& out) {
+        return detail::parse(data, size, handler, out);
+    }
+
+    /**
+     * Parse a geometry, calling all finish methods without output argument.
+     */
+    template <typename THandler>
+    std::size_t parse(const char* data, std::size_t size, THandler& handler) {
+        detail::no_output none;
+        return detail::parse(data, size, handler, none);
+    }
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_WKBPARSER_HPP */
@@ -0,0 +1,607 @@
+#ifndef WKBHPP_WKBVIEW_HPP
+#define WKBHPP_WKBVIEW_HPP
+
+/*
+
+This file is part of WKBHPP.
+
+Copyright 2019 Michael Reichert <code@michreichert.de> and others
+(see README).
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <wkbhpp/error.hpp>
+#include <wkbhpp/format.hpp>
+#include <wkbhpp/validate.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string>
+
+namespace wkbhpp {
+
+    namespace detail {
+
+        inline const char* status_message(wkb_status status) noexcept {
+            switch (status) {
+                case wkb_status::ok:
+                    break;
+                case wkb_status::truncated:
+                    return "WKB geometry truncated";
+                case wkb_status::invalid_byte_order:
+                    return "Invalid WKB byte order marker";
+                case wkb_status::unknown_type:
+                    return "Unknown WKB geometry type";
+                case wkb_status::invalid_member:
+                    return "Invalid member type in WKB multi geometry";
+                case wkb_status::nested_too_deeply:
+                    return "WKB geometry collections nested too deeply";
+                case wkb_status::trailing_bytes:
+                    return "Trailing bytes after WKB geometry";
+            }
+            return "";
+        }
+
+        inline void check(wkb_status status) {
+            if (status != wkb_status::ok) {
+                throw wkb_error{status_message(status)};
+            }
+        }
+
+        /**
+         * Read the header of the geometry at data.
+         *
+         * @throws wkb_error if the header is invalid or longer than size
+         */
+        inline wkb_header read_header(const char* data, std::size_t size) {
+            wkb_header header;
+            check(decode_header(data, size, header));
+            return header;
+        }
+
+        /**
+         * Read the number of points of a linestring or ring at offset and
+         * check that they fit into size.
+         *
+         * @returns offset after the points
+         */
+        inline std::size_t skip_points(const char* data, std::size_t size, std::size_t offset, const wkb_header& header) {
+            check(check_points(data, size, offset, header));
+            return offset;
+        }
+
+        /**
+         * Size in bytes of the geometry at data including all
+         * sub-geometries.
+         *
+         * @throws wkb_error if the geometry is invalid or longer than size
+         */
+        inline std::size_t geometry_size(const char* data, std::size_t size) {
+            std::size_t offset = 0;
+            check(check_geometry(data, size, offset));
+            return offset;
+        }
+
+    } // namespace detail
+
+    /**
+     * A point inside a WKB buffer. The coordinates are read on access.
+     */
+    class point_view {
+
+        const char* m_data;
+        bool m_swap;
+        bool m_has_z;
+        bool m_has_m;
+
+    public:
+
+        point_view(const char* data, bool swap, bool has_z, bool has_m) noexcept :
+            m_data(data),
+            m_swap(swap),
+            m_has_z(has_z),
+            m_has_m(has_m) {
+        }
+
+        double x() const noexcept {
+            return detail::read_value<double>(m_data, m_swap);
+        }
+
+        double y() const noexcept {
+            return detail::read_value<double>(m_data + sizeof(double), m_swap);
+        }
+
+        /**
+         * Z coordinate, NaN if the geometry has none.
+         */
+        double z() const noexcept {
+            if (!m_has_z) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            return detail::read_value<double>(m_data + 2 * sizeof(double), m_swap);
+        }
+
+        /**
+         * M value, NaN if the geometry has none.
+         */
+        double m() const noexcept {
+            if (!m_has_m) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            return detail::read_value<double>(m_data + (2 + m_has_z) * sizeof(double), m_swap);
+        }
+
+        const char* data() const noexcept {
+            return m_data;
+        }
+
+    }; // class point_view
+
+    /**
+     * The points of a linestring or ring inside a WKB buffer.
+     */
+    class point_sequence {
+
+        const char* m_data;
+        uint32_t m_size;
+        bool m_swap;
+        bool m_has_z;
+        bool m_has_m;
+
+        std::size_t stride() const noexcept {
+            return (2 + m_has_z + m_has_m) * sizeof(double);
+        }
+
+    public:
+
+        class iterator {
+
+            const char* m_data;
+            std::size_t m_stride;
+            bool m_swap;
+            bool m_has_z;
+            bool m_has_m;
+
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = point_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = point_view;
+
+            iterator(const char* data, std::size_t stride, bool swap, bool has_z, bool has_m) noexcept :
+                m_data(data),
+                m_stride(stride),
+                m_swap(swap),
+                m_has_z(has_z),
+                m_has_m(has_m) {
+            }
+
+            point_view operator*() const noexcept {
+                return point_view{m_data, m_swap, m_has_z, m_has_m};
+            }
+
+            iterator& operator++() noexcept {
+                m_data += m_stride;
+                return *this;
+            }
+
+            iterator operator++(int) noexcept {
+                iterator tmp{*this};
+                ++*this;
+                return tmp;
+            }
+
+            bool operator==(const iterator& other) const noexcept {
+                return m_data == other.m_data;
+            }
+
+            bool operator!=(const iterator& other) const noexcept {
+                return !(*this == other);
+            }
+
+        }; // class iterator
+
+        point_sequence(const char* data, uint32_t size, bool swap, bool has_z, bool has_m) noexcept :
+            m_data(data),
+            m_size(size),
+            m_swap(swap),
+            m_has_z(has_z),
+            m_has_m(has_m) {
+        }
+
+        std::size_t size() const noexcept {
+            return m_size;
+        }
+
+        bool empty() const noexcept {
+            return m_size == 0;
+        }
+
+        /**
+         * Pointer to the coordinates of the first point.
+         */
+        const char* data() const noexcept {
+            return m_data;
+        }
+
+        /**
+         * Size of the coordinates in bytes.
+         */
+        std::size_t bytes() const noexcept {
+            return m_size * stride();
+        }
+
+        point_view operator[](std::size_t n) const noexcept {
+            return point_view{m_data + n * stride(), m_swap, m_has_z, m_has_m};
+        }
+
+        iterator begin() const noexcept {
+            return iterator{m_data, stride(), m_swap, m_has_z, m_has_m};
+        }
+
+        iterator end() const noexcept {
+            return iterator{m_data + bytes(), stride(), m_swap, m_has_z, m_has_m};
+        }
+
+    }; // class point_sequence
+
+    /**
+     * The rings of a polygon inside a WKB buffer.
+     */
+    class ring_range {
+
+        const char* m_data;
+        uint32_t m_size;
+        bool m_swap;
+        bool m_has_z;
+        bool m_has_m;
+
+    public:
+
+        class iterator {
+
+            const char* m_data;
+            uint32_t m_index;
+            bool m_swap;
+            bool m_has_z;
+            bool m_has_m;
+
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = point_sequence;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = point_sequence;
+
+            iterator(const char* data, uint32_t index, bool swap, bool has_z, bool has_m) noexcept :
+                m_data(data),
+                m_index(index),
+                m_swap(swap),
+                m_has_z(has_z),
+                m_has_m(has_m) {
+            }
+
+            point_sequence operator*() const noexcept {
+                return point_sequence{m_data + sizeof(uint32_t),
+                                      detail::read_value<uint32_t>(m_data, m_swap),
+                                      m_swap, m_has_z, m_has_m};
+            }
+
+            iterator& operator++() noexcept {
+                m_data += sizeof(uint32_t) + (**this).bytes();
+                ++m_index;
+                return *this;
+            }
+
+            iterator operator++(int) noexcept {
+                iterator tmp{*this};
+                ++*this;
+                return tmp;
+            }
+
+            bool operator==(const iterator& other) const noexcept {
+                return m_index == other.m_index;
+            }
+
+            bool operator!=(const iterator& other) const noexcept {
+                return !(*this == other);
+            }
+
+        }; // class iterator
+
+        ring_range(const char* data, uint32_t size, bool swap, bool has_z, bool has_m) noexcept :
+            m_data(data),
+            m_size(size),
+            m_swap(swap),
+            m_has_z(has_z),
+            m_has_m(has_m) {
+        }
+
+        std::size_t size() const noexcept {
+            return m_size;
+        }
+
+        bool empty() const noexcept {
+            return m_size == 0;
+        }
+
+        iterator begin() const noexcept {
+            return iterator{m_data, 0, m_swap, m_has_z, m_has_m};
+        }
+
+        // Only the index is compared, the end iterator must not be
+        // dereferenced.
+        iterator end() const noexcept {
+            return iterator{m_data, m_size, m_swap, m_has_z, m_has_m};
+        }
+
+    }; // class ring_range
+
+    class geometry_range;
+
+    /**
+     * Read-only view of a WKB or EWKB geometry in a buffer. Nothing is
+     * copied, sub-geometries, rings and points are accessed through
+     * lazy iterators which decode the values on access. Bytes are only
+     * swapped if the byte order of the geometry differs from that of the
+     * machine.
+     *
+     * HEX encoded input has to be decoded with convert_from_hex() first.
+     */
+    class WKBView {
+
+        friend class geometry_range;
+
+        const char* m_data;
+        std::size_t m_size;
+        detail::wkb_header m_header;
+
+        WKBView(const char* data, std::size_t size, const detail::wkb_header& header) noexcept :
+            m_data(data),
+            m_size(size),
+            m_header(header) {
+        }
+
+        const char* body() const noexcept {
+            return m_data + m_header.size;
+        }
+
+        void require(geometry_type type, const char* message) const {
+            if (m_header.type != type) {
+                throw wkb_error{message};
+            }
+        }
+
+    public:
+
+        /**
+         * Create a view of the geometry at the start of the buffer. The
+         * buffer may contain more data after the geometry, size() returns
+         * the size of the geometry only.
+         *
+         * @throws wkb_error if the geometry is invalid or truncated
+         */
+        WKBView(const char* data, std::size_t size) :
+            m_data(data),
+            m_size(detail::geometry_size(data, size)),
+            m_header(detail::read_header(data, size)) {
+        }
+
+        explicit WKBView(const std::string& data) :
+            WKBView(data.data(), data.size()) {
+        }
+
+        geometry_type type() const noexcept {
+            return m_header.type;
+        }
+
+        byte_order order() const noexcept {
+            return m_header.order;
+        }
+
+        bool has_srid() const noexcept {
+            return m_header.has_srid;
+        }
+
+        /**
+         * SRID of an EWKB geometry, 0 if there is none.
+         */
+        int srid() const noexcept {
+            return m_header.srid;
+        }
+
+        bool has_z() const noexcept {
+            return m_header.has_z;
+        }
+
+        bool has_m() const noexcept {
+            return m_header.has_m;
+        }
+
+        const char* data() const noexcept {
+            return m_data;
+        }
+
+        /**
+         * Size of the geometry in bytes.
+         */
+        std::size_t size() const noexcept {
+            return m_size;
+        }
+
+        /**
+         * The coordinates of a Point.
+         *
+         * @throws wkb_error if the geometry is not a Point
+         */
+        point_view point() const {
+            require(geometry_type::point, "WKB geometry is not a Point");
+            return point_view{body(), m_header.swap(), m_header.has_z, m_header.has_m};
+        }
+
+        /**
+         * The points of a LineString.
+         *
+         * @throws wkb_error if the geometry is not a LineString
+         */
+        point_sequence points() const {
+            require(geometry_type::linestring, "WKB geometry is not a LineString");
+            return point_sequence{body() + sizeof(uint32_t),
+                                  detail::read_value<uint32_t>(body(), m_header.swap()),
+                                  m_header.swap(), m_header.has_z, m_header.has_m};
+        }
+
+        /**
+         * The rings of a Polygon, the first one is the outer ring.
+         *
+         * @throws wkb_error if the geometry is not a Polygon
+         */
+        ring_range rings() const {
+            require(geometry_type::polygon, "WKB geometry is not a Polygon");
+            return ring_range{body() + sizeof(uint32_t),
+                              detail::read_value<uint32_t>(body(), m_header.swap()),
+                              m_header.swap(), m_header.has_z, m_header.has_m};
+        }
+
+        /**
+         * The members of a multi geometry or GeometryCollection.
+         *
+         * @throws wkb_error if the geometry is not a collection
+         */
+        geometry_range geometries() const;
+
+    }; // class WKBView
+
+    /**
+     * The members of a multi geometry or GeometryCollection inside a WKB
+     * buffer.
+     */
+    class geometry_range {
+
+        const char* m_data;
+        const char* m_end;
+        uint32_t m_size;
+
+    public:
+
+        class iterator {
+
+            const char* m_end;
+            uint32_t m_index;
+            uint32_t m_size;
+
+            // view of the current member, only valid if m_index < m_size
+            WKBView m_current;
+
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = WKBView;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const WKBView*;
+            using reference = const WKBView&;
+
+            iterator(const char* data, const char* end, uint32_t index, uint32_t size) :
+                m_end(end),
+                m_index(index),
+                m_size(size),
+                m_current(index < size ? WKBView{data, static_cast<std::size_t>(end - data)} : WKBView{nullptr, 0, detail::wkb_header{}}) {
+            }
+
+            reference operator*() const noexcept {
+                return m_current;
+            }
+
+            pointer operator->() const noexcept {
+                return &m_current;
+            }
+
+            iterator& operator++() {
+                ++m_index;
+                if (m_index < m_size) {
+                    const char* next = m_current.data() + m_current.size();
+                    m_current = WKBView{next, static_cast<std::size_t>(m_end - next)};
+                }
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator tmp{*this};
+                ++*this;
+                return tmp;
+            }
+
+            bool operator==(const iterator& other) const noexcept {
+                return m_index == other.m_index;
+            }
+
+            bool operator!=(const iterator& other) const noexcept {
+                return !(*this == other);
+            }
+
+        }; // class iterator
+
+        geometry_range(const char* data, const char* end, uint32_t size) noexcept :
+            m_data(data),
+            m_end(end),
+            m_size(size) {
+        }
+
+        std::size_t size() const noexcept {
+            return m_size;
+        }
+
+        bool empty() const noexcept {
+            return m_size == 0;
+        }
+
+        iterator begin() const {
+            return iterator{m_data, m_end, 0, m_size};
+        }
+
+        iterator end() const {
+            return iterator{m_data, m_end, m_size, m_size};
+        }
+
+    }; // class geometry_range
+
+    inline geometry_range WKBView::geometries() const {
+        if (m_header.type < geometry_type::multipoint) {
+            throw wkb_error{"WKB geometry is not a collection"};
+        }
+        return geometry_range{body() + sizeof(uint32_t), m_data + m_size,
+                              detail::read_value<uint32_t>(body(), m_header.swap())};
+    }
+
+} // namespace wkbhpp
+
+#endif /* WKBHPP_WKBVIEW_HPP */
@@ -41,66 +41,57 @@ DEALINGS IN THE SOFTWARE.
 
 #define WKBHPP_VERSION_STRING "0.1.0"
 
-// macros for endianess (taken from Libosmium)
-// Windows is only available for little endian architectures
-// http://stackoverflow.com/questions/6449468/can-i-safely-assume-that-windows-installations-will-always-be-little-endian
-#if defined(__FreeBSD__)
-# include <sys/endian.h>
-#elif !defined(_WIN32) && !defined(__APPLE__)
-# include <endian.h>
-#else
-# define __LITTLE_ENDIAN 1234
-# define __BYTE_ORDER __LITTLE_ENDIAN
-#endif
+#include <wkbhpp/bbox.hpp>
+#include <wkbhpp/detail/coordinates.hpp>
+#include <wkbhpp/detail/endian.hpp>
+#include <wkbhpp/error.hpp>
+#include <wkbhpp/format.hpp>
+#include <wkbhpp/hex.hpp>
+#include <wkbhpp/metrics.hpp>
+#include <wkbhpp/point_traits.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <limits>
-#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace wkbhpp {
 
-    class wkb_error : public std::runtime_error {
-
-    public:
-
-        explicit wkb_error(const std::string& message) :
-            std::runtime_error(message) {
-        }
-
-    }; // class geometry_error
-
-    enum class wkb_type : bool {
-        wkb  = false,
-        ewkb = true
-    }; // enum class wkb_type
-
-    enum class out_type : bool {
-        binary = false,
-        hex    = true
-    }; // enum class out_type
-
     template <typename T>
     inline void str_push(std::string& str, T data) {
         str.append(reinterpret_cast<const char*>(&data), sizeof(T));
     }
 
-    inline std::string convert_to_hex(const std::string& str) {
-        static const char* lookup_hex = "0123456789ABCDEF";
-        std::string out;
-        out.reserve(str.size() * 2);
-
-        for (char c : str) {
-            out += lookup_hex[(static_cast<unsigned int>(c) >> 4u) & 0xfu];
-            out += lookup_hex[ static_cast<unsigned int>(c)        & 0xfu];
-        }
-
-        return out;
+    /**
+     * Append the HEX representation of the bytes of data to str.
+     */
+    template <typename T>
+    inline void str_push_hex(std::string& str, T data) {
+        char buffer[2 * sizeof(T)];
+        write_hex(buffer, reinterpret_cast<const char*>(&data), sizeof(T));
+        str.append(buffer, sizeof(buffer));
     }
 
-    class WKBWriter {
+    /**
+     * Writer for WKB geometries. The output format is described by TFormat,
+     * either dynamic_format (see WKBWriter) or static_format (see
+     * BasicWKBWriter).
+     *
+     * TBBox is the bounding box policy (see bbox.hpp), TMetrics the
+     * metrics policy (see metrics.hpp). They see all points while they are
+     * encoded, so no second pass over the coordinates is needed to get the
+     * envelope, area or length. The defaults no_bbox and no_metrics cost
+     * nothing.
+     */
+    template <typename TFormat, typename TBBox = no_bbox, typename TMetrics = no_metrics>
+    class GenericWKBWriter {
         /**
          * Type of WKB geometry.
          * These definitions are from
@@ -117,211 +108,1379 @@ namespace wkbhpp {
              wkbMultiPolygon        = 6,
              wkbGeometryCollection  = 7,
 
+             // offsets of the ISO type codes with Z and M
+             wkbIsoZ                = 1000,
+             wkbIsoM                = 2000,
+
+             // dimension flags (EWKB)
+             wkbZ                   = 0x80000000,
+             wkbM                   = 0x40000000,
+
              // SRID-presence flag (EWKB)
              wkbSRID                = 0x20000000
          }; // enum wkbGeometryType
 
+         // byte order marker, geometry type and SRID, as HEX
+         static constexpr const std::size_t max_header_chars = 2 * (1 + 2 * sizeof(uint32_t));
+
+    public:
+
          /**
-         * Byte order marker in WKB geometry.
-         */
-         enum class wkb_byte_order_type : uint8_t {
-             XDR = 0,         // Big Endian
-             NDR = 1          // Little Endian
-         }; // enum class wkb_byte_order_type
+          * Maximum number of characters written by make_point_into().
+          */
+         static constexpr const std::size_t max_point_size = max_header_chars + 2 * 4 * sizeof(double);
+
+    private:
 
+         TFormat m_format;
          std::string m_data;
-         uint32_t m_points = 0;
          int m_srid;
-         wkb_type m_wkb_type;
-         out_type m_out_type;
+         TBBox m_bbox;
+         TMetrics m_metrics;
 
-         std::size_t m_linestring_size_offset = 0;
-         std::size_t m_polygons = 0;
-         std::size_t m_rings = 0;
-         std::size_t m_multipolygon_size_offset = 0;
-         std::size_t m_polygon_size_offset = 0;
-         std::size_t m_ring_size_offset = 0;
+         // precomputed headers (without size fields) indexed by wkbGeometryType
+         char m_headers[wkbGeometryCollection + 1][max_header_chars];
 
-         std::size_t header(std::string& str, wkbGeometryType type, bool add_length) const {
-#if __BYTE_ORDER == __LITTLE_ENDIAN
-             str_push(str, wkb_byte_order_type::NDR);
-#else
-             str_push(str, wkb_byte_order_type::XDR);
-#endif
-             if (m_wkb_type == wkb_type::ewkb) {
-                 str_push(str, type | wkbSRID);
-                 str_push(str, m_srid);
+         /**
+          * An open geometry or ring: position of its size field in the
+          * output, number of members (points, rings, polygons, ...)
+          * added so far and whether it is a GeometryCollection.
+          */
+         struct frame {
+             std::size_t size_offset;
+             std::size_t count;
+             bool collection;
+         };
+
+         // Collections, the multi geometry inside the innermost collection
+         // and its polygon and ring.
+         static constexpr const std::size_t max_frames = max_collection_depth + 2;
+
+         // open geometries, innermost last
+         std::array<frame, max_frames> m_frames{};
+         std::size_t m_depth = 0;
+
+         ring_orientation m_outer_orientation = ring_orientation::any;
+         ring_orientation m_inner_orientation = ring_orientation::any;
+
+         // explode mode: start of each polygon of the outermost MultiPolygon
+         bool m_explode = false;
+         std::vector<std::size_t> m_polygon_offsets;
+
+         // number of points converted at once on the stack
+         static constexpr const std::size_t block_size = 64;
+
+         bool swap_bytes() const noexcept {
+             return m_format.order() != native_byte_order;
+         }
+
+         std::size_t chars_per_byte() const noexcept {
+             return m_format.otype() == out_type::hex ? 2 : 1;
+         }
+
+         std::size_t header_chars() const noexcept {
+             return chars_per_byte() * (m_format.wtype() == wkb_type::ewkb ? 1 + 2 * sizeof(uint32_t) : 1 + sizeof(uint32_t));
+         }
+
+         void init_headers() {
+             const bool z = has_z(m_format.dims());
+             const bool m = has_m(m_format.dims());
+             const uint32_t ewkb_flags = static_cast<uint32_t>(wkbSRID) | (z ? static_cast<uint32_t>(wkbZ) : 0u) |
+                                         (m ? static_cast<uint32_t>(wkbM) : 0u);
+             const uint32_t iso_offset = (z ? static_cast<uint32_t>(wkbIsoZ) : 0u) +
+                                         (m ? static_cast<uint32_t>(wkbIsoM) : 0u);
+             for (uint32_t type = wkbPoint; type <= wkbGeometryCollection; ++type) {
+                 std::string header;
+                 push(header, m_format.order());
+                 if (m_format.wtype() == wkb_type::ewkb) {
+                     push(header, type | ewkb_flags);
+                     push(header, m_srid);
+                 } else {
+                     push(header, type + iso_offset);
+                 }
+                 std::copy_n(header.data(), header.size(), m_headers[type]);
+             }
+         }
+
+         /**
+          * Append size bytes either as binary or directly as HEX,
+          * depending on the output type.
+          */
+         void append_bytes(std::string& str, const char* data, const std::size_t size) const {
+             if (m_format.otype() == out_type::hex) {
+                 const std::size_t offset = str.size();
+                 str.resize(offset + 2 * size);
+                 write_hex(&str[offset], data, size);
+             } else {
+                 str.append(data, size);
+             }
+         }
+
+         /**
+          * Append data to str in the output byte order, either as binary or
+          * directly as HEX, depending on the output type.
+          */
+         template <typename T>
+         void push(std::string& str, T data) const {
+             if (swap_bytes()) {
+                 data = detail::byte_swap_value(data);
+             }
+             if (m_format.otype() == out_type::hex) {
+                 str_push_hex(str, data);
              } else {
-                 str_push(str, type);
+                 str_push(str, data);
              }
+         }
+
+         /**
+          * Throw if n coordinates per point do not match the dimensions of
+          * the output.
+          */
+         void check_stride(const std::size_t n) const {
+             if (n != m_format.stride()) {
+                 throw wkb_error{"Number of coordinates does not match the dimensions of the writer"};
+             }
+         }
+
+         /**
+          * Append the n coordinates of a point to str.
+          */
+         void push_coordinates(std::string& str, const double* coords, const std::size_t n) const {
+             check_stride(n);
+             for (std::size_t i = 0; i < n; ++i) {
+                 push(str, coords[i]);
+             }
+         }
+
+         /* Hooks of the bounding box and metrics policies */
+
+         void on_reset() {
+             m_bbox.reset();
+             m_metrics.reset();
+         }
+
+         void on_add_point(const double x, const double y) {
+             m_bbox.add_point(x, y);
+             m_metrics.add_point(x, y);
+         }
+
+         void on_add_points(const double* coords, const std::size_t n, const std::size_t stride) {
+             m_bbox.add_points(coords, n, stride);
+             m_metrics.add_points(coords, n, stride);
+         }
+
+         void on_add_points(const double* x, const double* y, const std::size_t n) {
+             m_bbox.add_points(x, y, n);
+             m_metrics.add_points(x, y, n);
+         }
+
+         void on_linestring_start() {
+             m_bbox.linestring_start();
+             m_metrics.linestring_start();
+         }
+
+         void on_linestring_finish() {
+             m_bbox.linestring_finish();
+             m_metrics.linestring_finish();
+         }
+
+         void on_ring_start() {
+             m_bbox.ring_start();
+             m_metrics.ring_start();
+         }
+
+         void on_ring_finish() {
+             m_bbox.ring_finish();
+             m_metrics.ring_finish();
+         }
+
+         void on_polygon_start() {
+             m_bbox.polygon_start();
+             m_metrics.polygon_start();
+         }
+
+         void on_polygon_finish() {
+             m_bbox.polygon_finish();
+             m_metrics.polygon_finish();
+         }
+
+         /**
+          * Append the n coordinates of a point to the open geometry.
+          */
+         void push_location(const double* coords, const std::size_t n) {
+             push_coordinates(m_data, coords, n);
+             on_add_point(coords[0], coords[1]);
+         }
+
+         /**
+          * Append the precomputed header of the given type to str. If
+          * add_length is set, a placeholder for the size follows the header.
+          * Returns the offset of this placeholder.
+          */
+         std::size_t header(std::string& str, wkbGeometryType type, bool add_length) const {
+             str.append(m_headers[type], header_chars());
              const std::size_t offset = str.size();
              if (add_length) {
-                 str_push(str, static_cast<uint32_t>(0));
+                 push(str, static_cast<uint32_t>(0));
              }
              return offset;
          }
 
+         /**
+          * Backpatch a size field. The offset is a position in the output,
+          * i.e. it counts characters if the output type is HEX.
+          */
          void set_size(const std::size_t offset, const std::size_t size) {
              if (size > std::numeric_limits<uint32_t>::max()) {
                  throw wkb_error{"Too many points in geometry"};
              }
-             const auto s = static_cast<uint32_t>(size);
-             std::copy_n(reinterpret_cast<const char*>(&s), sizeof(uint32_t), &m_data[offset]);
+             auto s = static_cast<uint32_t>(size);
+             if (swap_bytes()) {
+                 s = detail::byte_swap(s);
+             }
+             if (m_format.otype() == out_type::hex) {
+                 write_hex(&m_data[offset], reinterpret_cast<const char*>(&s), sizeof(uint32_t));
+             } else {
+                 std::copy_n(reinterpret_cast<const char*>(&s), sizeof(uint32_t), &m_data[offset]);
+             }
+         }
+
+         void push_frame(const std::size_t size_offset, const bool collection = false) {
+             if (m_depth == max_frames) {
+                 throw wkb_error{"Geometry collections nested too deeply"};
+             }
+             m_frames[m_depth] = frame{size_offset, 0, collection};
+             ++m_depth;
+         }
+
+         /**
+          * Does a geometry started now begin a new output? This is the
+          * case unless the innermost open geometry is a GeometryCollection.
+          * Geometries left open, e.g. after an exception, are discarded.
+          */
+         bool at_top_level() const noexcept {
+             return m_depth == 0 || !m_frames[m_depth - 1].collection;
+         }
+
+         /**
+          * Start a geometry. At the outermost level this starts a new
+          * output, otherwise the geometry becomes a member of the open
+          * GeometryCollection.
+          */
+         void open_geometry(wkbGeometryType type) {
+             if (at_top_level()) {
+                 reset();
+                 push_frame(header(m_data, type, true), type == wkbGeometryCollection);
+             } else {
+                 open_member(type);
+             }
+         }
+
+         /**
+          * Start a geometry as member of the innermost open one.
+          */
+         void open_member(wkbGeometryType type) {
+             ++current_count();
+             push_frame(m_data.size() + header_chars(), type == wkbGeometryCollection);
+             header(m_data, type, true);
+         }
+
+         /**
+          * Add a point as member of the innermost open geometry.
+          */
+         void add_point_member(const double* coords, const std::size_t n) {
+             check_stride(n);
+             ++current_count();
+             header(m_data, wkbPoint, false);
+             push_location(coords, n);
+         }
+
+         /**
+          * Add a point to the innermost open linestring or ring.
+          */
+         void add_location(const double* coords, const std::size_t n) {
+             push_location(coords, n);
+             ++current_count();
+         }
+
+         void open_ring() {
+             on_ring_start();
+             ++current_count();
+             push_frame(m_data.size());
+             push(m_data, static_cast<uint32_t>(0));
+         }
+
+         /**
+          * Number of members of the innermost open geometry or ring.
+          */
+         std::size_t& current_count() noexcept {
+             return m_frames[m_depth - 1].count;
+         }
+
+         /**
+          * Backpatch the size of the innermost open geometry or ring with
+          * the given number of members and close it.
+          *
+          * @returns true if the outermost geometry is complete
+          */
+         bool close(const std::size_t count) {
+             --m_depth;
+             set_size(m_frames[m_depth].size_offset, count);
+             return m_depth == 0;
+         }
+
+         bool close() {
+             return close(m_frames[m_depth - 1].count);
+         }
+
+         /**
+          * Signed area (positive if counterclockwise) of the count points
+          * in m_data starting at offset, computed from the encoded bytes.
+          */
+         double ring_area(const std::size_t offset, const std::size_t count) const {
+             const std::size_t stride = m_format.stride();
+             const std::size_t point_chars = chars_per_byte() * stride * sizeof(double);
+             double buffer[block_size * 4];
+             double origin_x = 0;
+             double origin_y = 0;
+             double prev_x = 0;
+             double prev_y = 0;
+             double sum = 0;
+             for (std::size_t i = 0; i < count; i += block_size) {
+                 const std::size_t n = std::min(block_size, count - i);
+                 const char* src = &m_data[offset + i * point_chars];
+                 char* bytes = reinterpret_cast<char*>(buffer);
+                 if (m_format.otype() == out_type::hex) {
+                     read_hex(bytes, src, n * point_chars);
+                 } else {
+                     std::memcpy(bytes, src, n * point_chars);
+                 }
+                 if (swap_bytes()) {
+                     detail::byte_swap_doubles(bytes, bytes, n * stride);
+                 }
+                 for (std::size_t j = 0; j < n; ++j) {
+                     // shoelace formula relative to the first point
+                     if (i + j == 0) {
+                         origin_x = buffer[0];
+                         origin_y = buffer[1];
+                         continue;
+                     }
+                     const double x = buffer[j * stride] - origin_x;
+                     const double y = buffer[j * stride + 1] - origin_y;
+                     sum += prev_x * y - x * prev_y;
+                     prev_x = x;
+                     prev_y = y;
+                 }
+             }
+             return sum / 2;
+         }
+
+         /**
+          * Reverse the points of the innermost open ring if its winding
+          * order is not the wanted one.
+          */
+         void orient_ring(const ring_orientation wanted) {
+             if (wanted == ring_orientation::any) {
+                 return;
+             }
+             const frame& ring = m_frames[m_depth - 1];
+             const std::size_t offset = ring.size_offset + chars_per_byte() * sizeof(uint32_t);
+             const double area = ring_area(offset, ring.count);
+             if ((wanted == ring_orientation::ccw && area < 0) || (wanted == ring_orientation::cw && area > 0)) {
+                 detail::reverse_records(&m_data[offset], ring.count,
+                                         chars_per_byte() * m_format.stride() * sizeof(double));
+             }
+         }
+
+         void close_ring(const ring_orientation wanted) {
+             orient_ring(wanted);
+             on_ring_finish();
+             close();
+         }
+
+         void open_polygon() {
+             open_geometry(wkbPolygon);
+             on_polygon_start();
+         }
+
+         bool close_polygon() {
+             on_polygon_finish();
+             return close();
+         }
+
+         /**
+          * Append n points of stride() interleaved coordinates each with a
+          * single size check.
+          */
+         void push_locations(const double* coords, const std::size_t n) {
+             const std::size_t stride = m_format.stride();
+             on_add_points(coords, n, stride);
+             if (!swap_bytes()) {
+                 append_bytes(m_data, reinterpret_cast<const char*>(coords), stride * sizeof(double) * n);
+                 return;
+             }
+             reserve_points(n);
+             char buffer[block_size * 4 * sizeof(double)];
+             for (std::size_t i = 0; i < n; i += block_size) {
+                 const std::size_t count = std::min(block_size, n - i);
+                 detail::byte_swap_doubles(buffer, reinterpret_cast<const char*>(coords + stride * i), stride * count);
+                 append_bytes(m_data, buffer, count * stride * sizeof(double));
+             }
+         }
+
+         /**
+          * Append n points given as separate x and y arrays.
+          */
+         void push_locations(const double* x, const double* y, const std::size_t n) {
+             check_stride(2);
+             on_add_points(x, y, n);
+             if (m_format.otype() == out_type::binary && !swap_bytes()) {
+                 const std::size_t offset = m_data.size();
+                 m_data.resize(offset + 2 * sizeof(double) * n);
+                 detail::interleave_xy(&m_data[offset], x, y, n);
+                 return;
+             }
+             // interleave blocks of points on the stack, then convert them
+             reserve_points(n);
+             char buffer[block_size * 2 * sizeof(double)];
+             for (std::size_t i = 0; i < n; i += block_size) {
+                 const std::size_t count = std::min(block_size, n - i);
+                 detail::interleave_xy(buffer, x + i, y + i, count);
+                 if (swap_bytes()) {
+                     detail::byte_swap_doubles(buffer, buffer, 2 * count);
+                 }
+                 append_bytes(m_data, buffer, count * 2 * sizeof(double));
+             }
+         }
+
+         /**
+          * Make sure that m_data can hold n more points without reallocation.
+          * (Only grows the buffer, reserve() may shrink it with some
+          * standard libraries.)
+          */
+         void reserve_points(const std::size_t n) {
+             const std::size_t point_chars = chars_per_byte() * m_format.stride() * sizeof(double);
+             const std::size_t needed = m_data.size() + n * point_chars;
+             if (needed > m_data.capacity()) {
+                 m_data.reserve(needed);
+             }
+         }
+
+         template <typename TIterator>
+         void reserve_points(TIterator first, TIterator last, std::forward_iterator_tag /*unused*/) {
+             reserve_points(static_cast<std::size_t>(std::distance(first, last)));
+         }
+
+         template <typename TIterator>
+         void reserve_points(TIterator /*first*/, TIterator /*last*/, std::input_iterator_tag /*unused*/) {
+         }
+
+         /**
+          * Pointers to points with the memory layout of x/y pairs are
+          * copied in bulk.
+          */
+         template <typename TIterator>
+         std::size_t push_points(TIterator first, TIterator last, std::true_type /*xy_pointer*/) {
+             const auto n = static_cast<std::size_t>(last - first);
+             push_locations(reinterpret_cast<const double*>(first), n);
+             return n;
+         }
+
+         template <typename TIterator>
+         std::size_t push_points(TIterator first, TIterator last, std::false_type /*xy_pointer*/) {
+             using traits = point_traits<detail::iterator_value_type<TIterator>>;
+             reserve_points(first, last, typename std::iterator_traits<TIterator>::iterator_category{});
+             std::size_t n = 0;
+             for (; first != last; ++first) {
+                 const double xy[2] = {traits::x(*first), traits::y(*first)};
+                 push(m_data, xy[0]);
+                 push(m_data, xy[1]);
+                 on_add_point(xy[0], xy[1]);
+                 ++n;
+             }
+             return n;
+         }
+
+         template <typename TIterator>
+         std::size_t push_points(TIterator first, TIterator last) {
+             check_stride(2);
+             return push_points(first, last, detail::is_xy_pointer<TIterator>{});
+         }
+
+         template <typename TRange>
+         std::size_t push_range(const TRange& points, std::true_type /*contiguous*/) {
+             return push_points(points.data(), points.data() + points.size());
+         }
+
+         template <typename TRange>
+         std::size_t push_range(const TRange& points, std::false_type /*contiguous*/) {
+             using std::begin;
+             using std::end;
+             return push_points(begin(points), end(points));
+         }
+
+         template <typename TRange>
+         std::size_t push_range(const TRange& points) {
+             return push_range(points, detail::is_contiguous_range<TRange>{});
+         }
+
+         template <typename TRings>
+         void push_polygon(const TRings& rings) {
+             polygon_start();
+             bool outer = true;
+             for (const auto& ring : rings) {
+                 if (outer) {
+                     polygon_outer_ring_start();
+                 } else {
+                     polygon_inner_ring_start();
+                 }
+                 polygon_add_locations(ring);
+                 if (outer) {
+                     polygon_outer_ring_finish();
+                 } else {
+                     polygon_inner_ring_finish();
+                 }
+                 outer = false;
+             }
+         }
+
+         /**
+          * Write count point records to out. coords holds the coordinates
+          * of count points in the output byte order.
+          */
+         void write_point_records(const char* coords, const std::size_t count, char* out) const noexcept {
+             const std::size_t hsize = header_chars();
+             const std::size_t csize = chars_per_byte() * m_format.stride() * sizeof(double);
+             const std::size_t record_size = hsize + csize;
+
+             char hex_coords[block_size * 8 * sizeof(double)];
+             if (m_format.otype() == out_type::hex) {
+                 write_hex(hex_coords, coords, count * m_format.stride() * sizeof(double));
+                 coords = hex_coords;
+             }
+
+#if WKBHPP_HAS_SSE2
+             // The header is stamped with one or two 16 byte stores. They
+             // write beyond the header but that part is overwritten by the
+             // coordinates afterwards. Records are at least 21 bytes long.
+             char padded_header[32] = {};
+             std::copy_n(m_headers[wkbPoint], hsize, padded_header);
+             const __m128i header0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded_header));
+             const __m128i header1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded_header + 16));
+             for (std::size_t i = 0; i < count; ++i) {
+                 _mm_storeu_si128(reinterpret_cast<__m128i*>(out), header0);
+                 if (hsize > 16) {
+                     _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), header1);
+                 }
+                 std::memcpy(out + hsize, coords + i * csize, csize);
+                 out += record_size;
+             }
+#else
+             for (std::size_t i = 0; i < count; ++i) {
+                 std::memcpy(out, m_headers[wkbPoint], hsize);
+                 std::memcpy(out + hsize, coords + i * csize, csize);
+                 out += record_size;
+             }
+#endif
+         }
+
+         /**
+          * Resize out for n point records and fill offsets.
+          * Returns the offset of the first record.
+          */
+         std::size_t prepare_point_records(const std::size_t n, std::string& out, std::size_t* offsets) const {
+             const std::size_t record_size = point_size();
+             const std::size_t offset = out.size();
+             out.resize(offset + n * record_size);
+             if (offsets) {
+                 for (std::size_t i = 0; i <= n; ++i) {
+                     offsets[i] = offset + i * record_size;
+                 }
+             }
+             return offset;
+         }
+
+         std::string take_data() {
+             std::string data;
+
+             using std::swap;
+             swap(data, m_data);
+
+             return data;
+         }
+
+         void append_data(std::string& out) const {
+             out.append(m_data);
          }
 
     public:
-         explicit WKBWriter(int srid, wkb_type wtype = wkb_type::wkb, out_type otype = out_type::binary) :
+         explicit GenericWKBWriter(int srid, TFormat format = TFormat{}, TBBox bbox = TBBox{},
+                                   TMetrics metrics = TMetrics{}) :
+             m_format(format),
              m_srid(srid),
-             m_wkb_type(wtype),
-             m_out_type(otype) {
+             m_bbox(std::move(bbox)),
+             m_metrics(std::move(metrics)) {
+             init_headers();
+         }
+
+         /**
+          * Constructor for writers with runtime format (i.e. WKBWriter).
+          * Byte orders other than the native one cost a byte swap of every
+          * value written.
+          */
+         GenericWKBWriter(int srid, wkb_type wtype, out_type otype = out_type::binary,
+                          byte_order order = native_byte_order, dimensions dims = dimensions::xy) :
+             GenericWKBWriter(srid, TFormat{wtype, otype, order, dims}) {
+         }
+
+         const TFormat& format() const noexcept {
+             return m_format;
+         }
+
+         /**
+          * The bounding box policy. After a finish method has completed the
+          * outermost geometry it holds the bounding boxes of that geometry,
+          * e.g. bbox().geometry() with geometry_bbox. They stay valid until
+          * the next geometry is started. Points created with the const
+          * methods (make_point(), make_point_into(), encode_points()) are
+          * not tracked.
+          */
+         const TBBox& bbox() const noexcept {
+             return m_bbox;
+         }
+
+         /**
+          * Set the winding order of outer and inner rings. When a ring is
+          * finished, its signed area is computed from the bytes already
+          * written and the points are reversed in place if needed. The
+          * bounding box and metrics policies see the rings as they were
+          * added, i.e. metrics().ring_areas() has the original signs.
+          */
+         void set_ring_orientation(const ring_orientation outer, const ring_orientation inner) noexcept {
+             m_outer_orientation = outer;
+             m_inner_orientation = inner;
+         }
+
+         /**
+          * Discard the geometry being built, if any. Not needed before
+          * starting a new geometry: a *_start() method called while no
+          * GeometryCollection is open does the same, e.g. after an
+          * exception left a geometry unfinished.
+          */
+         void reset() {
+             m_depth = 0;
+             m_data.clear();
+             m_polygon_offsets.clear();
+             on_reset();
+         }
+
+         /**
+          * Enable or disable explode mode. In explode mode the writer
+          * remembers where each polygon of an outermost MultiPolygon
+          * starts, so that multipolygon_finish(std::string&,
+          * std::vector<TOffset>&) can hand out the polygons as separate
+          * geometries.
+          */
+         void set_explode(const bool explode) noexcept {
+             m_explode = explode;
+         }
+
+         bool explode() const noexcept {
+             return m_explode;
+         }
+
+         /**
+          * The metrics policy. Like bbox() it holds the results for the
+          * last finished geometry, e.g. metrics().area() with
+          * planar_metrics.
+          */
+         const TMetrics& metrics() const noexcept {
+             return m_metrics;
          }
 
          /* Point */
+
+         /**
+          * Create a point. The number of coordinates given must match the
+          * dimensions of the writer: x/y for dimensions::xy, x/y and Z or M
+          * for dimensions::xyz and dimensions::xym, x/y/z/m for
+          * dimensions::xyzm. Otherwise a wkb_error is thrown. This holds for
+          * all methods taking the coordinates of single points.
+          */
          std::string make_point(const double x, const double y) const {
              std::string data;
-             header(data, wkbPoint, false);
-             str_push(data, x);
-             str_push(data, y);
+             make_point(x, y, data);
+             return data;
+         }
 
-             if (m_out_type == out_type::hex) {
-                 return convert_to_hex(data);
-             }
+         std::string make_point(const double x, const double y, const double c) const {
+             std::string data;
+             make_point(x, y, c, data);
+             return data;
+         }
 
+         std::string make_point(const double x, const double y, const double z, const double m) const {
+             std::string data;
+             make_point(x, y, z, m, data);
              return data;
          }
 
+         /**
+          * Create a point and append it to out.
+          */
+         void make_point(const double x, const double y, std::string& out) const {
+             const double coords[2] = {x, y};
+             check_stride(2);
+             header(out, wkbPoint, false);
+             push_coordinates(out, coords, 2);
+         }
+
+         void make_point(const double x, const double y, const double c, std::string& out) const {
+             const double coords[3] = {x, y, c};
+             check_stride(3);
+             header(out, wkbPoint, false);
+             push_coordinates(out, coords, 3);
+         }
+
+         void make_point(const double x, const double y, const double z, const double m, std::string& out) const {
+             const double coords[4] = {x, y, z, m};
+             check_stride(4);
+             header(out, wkbPoint, false);
+             push_coordinates(out, coords, 4);
+         }
+
+         /**
+          * Size of a point created by make_point_into().
+          */
+         std::size_t point_size() const noexcept {
+             return header_chars() + chars_per_byte() * m_format.stride() * sizeof(double);
+         }
+
+         /**
+          * Write a point with stride() coordinates to out without using the
+          * heap. out must have room for point_size() (at most
+          * max_point_size) characters.
+          *
+          * @returns the number of characters written
+          */
+         std::size_t make_point_into(const double* coords, char* out) const noexcept {
+             const std::size_t hsize = header_chars();
+             const std::size_t csize = m_format.stride() * sizeof(double);
+             std::copy_n(m_headers[wkbPoint], hsize, out);
+             double buffer[4];
+             const char* bytes = reinterpret_cast<const char*>(coords);
+             if (swap_bytes()) {
+                 detail::byte_swap_doubles(reinterpret_cast<char*>(buffer), bytes, m_format.stride());
+                 bytes = reinterpret_cast<const char*>(buffer);
+             }
+             if (m_format.otype() == out_type::hex) {
+                 write_hex(out + hsize, bytes, csize);
+             } else {
+                 std::copy_n(bytes, csize, out + hsize);
+             }
+             return point_size();
+         }
+
+         /**
+          * Write a 2D point to out, see make_point_into(const double*, char*).
+          * Throws wkb_error if the writer has Z or M.
+          */
+         std::size_t make_point_into(const double x, const double y, char* out) const {
+             check_stride(2);
+             const double xy[2] = {x, y};
+             return make_point_into(xy, out);
+         }
+
+         /**
+          * Create a 2D point in a std::array of exactly the size of a point
+          * in the output format (21 or 25 bytes, 42 or 50 characters as
+          * HEX). Only available if the format is fixed at compile time,
+          * i.e. for BasicWKBWriter.
+          */
+         template <typename TF = TFormat>
+         std::array<char, TF::point_size()> make_point_array(const double x, const double y) const noexcept {
+             static_assert(TF::stride() == 2, "make_point_array() needs a writer without Z and M");
+             std::array<char, TF::point_size()> out;
+             const double xy[2] = {x, y};
+             make_point_into(xy, out.data());
+             return out;
+         }
+
+         /**
+          * Encode n points given as interleaved coordinates (stride() values
+          * per point) as independent point records and append them to out.
+          * All records have the same size (point_size()), so record i
+          * starts at out.size() (before the call) + i * point_size().
+          *
+          * @param offsets If not nullptr, it must have room for n + 1
+          *                entries. offsets[i] is set to the start of
+          *                point i in out, offsets[n] to the end of the
+          *                last point.
+          */
+         void encode_points(const double* xy, const std::size_t n, std::string& out, std::size_t* offsets = nullptr) const {
+             const std::size_t offset = prepare_point_records(n, out, offsets);
+             const std::size_t record_size = point_size();
+             const std::size_t stride = m_format.stride();
+             char buffer[block_size * 4 * sizeof(double)];
+             for (std::size_t i = 0; i < n; i += block_size) {
+                 const std::size_t count = std::min(block_size, n - i);
+                 const char* coords = reinterpret_cast<const char*>(xy + stride * i);
+                 if (swap_bytes()) {
+                     detail::byte_swap_doubles(buffer, coords, stride * count);
+                     coords = buffer;
+                 }
+                 write_point_records(coords, count, &out[offset + i * record_size]);
+             }
+         }
+
+         /**
+          * Encode n points given as separate x and y arrays, see
+          * encode_points(const double*, std::size_t, std::string&, std::size_t*).
+          */
+         void encode_points(const double* x, const double* y, const std::size_t n, std::string& out, std::size_t* offsets = nullptr) const {
+             check_stride(2);
+             const std::size_t offset = prepare_point_records(n, out, offsets);
+             const std::size_t record_size = point_size();
+             char buffer[block_size * 2 * sizeof(double)];
+             for (std::size_t i = 0; i < n; i += block_size) {
+                 const std::size_t count = std::min(block_size, n - i);
+                 detail::interleave_xy(buffer, x + i, y + i, count);
+                 if (swap_bytes()) {
+                     detail::byte_swap_doubles(buffer, buffer, 2 * count);
+                 }
+                 write_point_records(buffer, count, &out[offset + i * record_size]);
+             }
+         }
+
          /* LineString */
 
          void linestring_start() {
-             m_data.clear();
-             m_linestring_size_offset = header(m_data, wkbLineString, true);
+             open_geometry(wkbLineString);
+             on_linestring_start();
          }
 
          void linestring_add_location(const double x, const double y) {
-             str_push(m_data, x);
-             str_push(m_data, y);
+             const double coords[2] = {x, y};
+             push_location(coords, 2);
          }
 
-         std::string linestring_finish(std::size_t num_points) {
-             set_size(m_linestring_size_offset, num_points);
-             std::string data;
+         void linestring_add_location(const double x, const double y, const double c) {
+             const double coords[3] = {x, y, c};
+             push_location(coords, 3);
+         }
 
-             using std::swap;
-             swap(data, m_data);
+         void linestring_add_location(const double x, const double y, const double z, const double m) {
+             const double coords[4] = {x, y, z, m};
+             push_location(coords, 4);
+         }
+
+         /**
+          * Add n points given as an array of interleaved coordinates with
+          * stride() values per point (x0, y0, x1, y1, ... in 2D, x0, y0, z0,
+          * x1, ... in 3D). The coordinates are copied in bulk.
+          */
+         void linestring_add_locations(const double* xy, const std::size_t n) {
+             push_locations(xy, n);
+         }
 
-             if (m_out_type == out_type::hex) {
-                 return convert_to_hex(data);
+         /**
+          * Add n points given as separate arrays of x and y coordinates.
+          * Only for writers without Z and M, like the iterator and range
+          * versions.
+          */
+         void linestring_add_locations(const double* x, const double* y, const std::size_t n) {
+             push_locations(x, y, n);
+         }
+
+         /**
+          * Add the points in [first, last). The value type of the iterator
+          * must be supported by point_traits. Pointers to types with
+          * point_traits<T>::xy_layout are copied in bulk.
+          */
+         template <typename TIterator>
+         void linestring_add_locations(TIterator first, TIterator last) {
+             push_points(first, last);
+         }
+
+         /**
+          * Add all points of a range. Ranges with data() and size() (e.g.
+          * std::vector) of types with point_traits<T>::xy_layout are copied
+          * in bulk.
+          */
+         template <typename TRange>
+         void linestring_add_locations(const TRange& points) {
+             push_range(points);
+         }
+
+         /**
+          * Create a linestring from a range of points.
+          */
+         template <typename TRange>
+         std::string make_linestring(const TRange& points) {
+             linestring_start();
+             return linestring_finish(push_range(points));
+         }
+
+         /**
+          * Create a linestring from a range of points and append it to out.
+          */
+         template <typename TRange>
+         void make_linestring(const TRange& points, std::string& out) {
+             linestring_start();
+             linestring_finish(push_range(points), out);
+         }
+
+         /**
+          * Finish the linestring. Inside a GeometryCollection it is added to
+          * the collection and an empty string is returned. This holds for
+          * the finish methods of all geometry types.
+          */
+         std::string linestring_finish(std::size_t num_points) {
+             on_linestring_finish();
+             if (close(num_points)) {
+                 return take_data();
              }
+             return std::string{};
+         }
 
-             return data;
+         /**
+          * Finish the linestring and append it to out.
+          *
+          * Unlike linestring_finish(std::size_t) the internal buffer keeps
+          * its capacity for the next geometry. If the caller reuses out
+          * (e.g. by clearing it after each batch), no heap allocations
+          * happen once the buffers have grown to the size of the largest
+          * geometry.
+          */
+         void linestring_finish(std::size_t num_points, std::string& out) {
+             on_linestring_finish();
+             if (close(num_points)) {
+                 append_data(out);
+             }
          }
 
          /* Polygon */
 
          void polygon_start() {
-             m_data.clear();
-             m_rings = 0;
-             m_polygon_size_offset = header(m_data, wkbPolygon, true);
+             open_polygon();
          }
 
          void polygon_outer_ring_start() {
-             ++m_rings;
-             m_points = 0;
-             m_ring_size_offset = m_data.size();
-             str_push(m_data, static_cast<uint32_t>(0));
+             open_ring();
          }
 
          void polygon_outer_ring_finish() {
-             set_size(m_ring_size_offset, m_points);
+             close_ring(m_outer_orientation);
          }
 
          void polygon_inner_ring_start() {
-             polygon_outer_ring_start();
+             open_ring();
          }
 
          void polygon_inner_ring_finish() {
-             polygon_outer_ring_finish();
+             close_ring(m_inner_orientation);
          }
 
          void polygon_add_location(const double x, const double y) {
              multipolygon_add_location(x, y);
          }
 
+         void polygon_add_location(const double x, const double y, const double c) {
+             multipolygon_add_location(x, y, c);
+         }
+
+         void polygon_add_location(const double x, const double y, const double z, const double m) {
+             multipolygon_add_location(x, y, z, m);
+         }
+
+         /**
+          * Add n points of the current ring, see linestring_add_locations().
+          */
+         void polygon_add_locations(const double* xy, const std::size_t n) {
+             multipolygon_add_locations(xy, n);
+         }
+
+         void polygon_add_locations(const double* x, const double* y, const std::size_t n) {
+             multipolygon_add_locations(x, y, n);
+         }
+
+         template <typename TIterator>
+         void polygon_add_locations(TIterator first, TIterator last) {
+             multipolygon_add_locations(first, last);
+         }
+
+         template <typename TRange>
+         void polygon_add_locations(const TRange& points) {
+             multipolygon_add_locations(points);
+         }
+
          std::string polygon_finish() {
-             set_size(m_polygon_size_offset, m_rings);
-             std::string data;
+             if (close_polygon()) {
+                 return take_data();
+             }
+             return std::string{};
+         }
 
-             using std::swap;
-             swap(data, m_data);
+         /**
+          * Finish the polygon and append it to out. The internal buffer
+          * keeps its capacity, see linestring_finish(std::size_t, std::string&).
+          */
+         void polygon_finish(std::string& out) {
+             if (close_polygon()) {
+                 append_data(out);
+             }
+         }
+
+         /**
+          * Create a polygon from a range of rings, each of them a range of
+          * points. The first ring is the outer ring.
+          */
+         template <typename TRings>
+         std::string make_polygon(const TRings& rings) {
+             push_polygon(rings);
+             return polygon_finish();
+         }
+
+         /**
+          * Create a polygon from a range of rings and append it to out.
+          */
+         template <typename TRings>
+         void make_polygon(const TRings& rings, std::string& out) {
+             push_polygon(rings);
+             polygon_finish(out);
+         }
+
+         /* MultiPoint */
 
-             if (m_out_type == out_type::hex) {
-                 return convert_to_hex(data);
+         void multipoint_start() {
+             open_geometry(wkbMultiPoint);
+         }
+
+         void multipoint_add_location(const double x, const double y) {
+             const double coords[2] = {x, y};
+             add_point_member(coords, 2);
+         }
+
+         void multipoint_add_location(const double x, const double y, const double c) {
+             const double coords[3] = {x, y, c};
+             add_point_member(coords, 3);
+         }
+
+         void multipoint_add_location(const double x, const double y, const double z, const double m) {
+             const double coords[4] = {x, y, z, m};
+             add_point_member(coords, 4);
+         }
+
+         /**
+          * Add n points given as interleaved coordinates. The point records
+          * are written in bulk, see encode_points().
+          */
+         void multipoint_add_locations(const double* xy, const std::size_t n) {
+             encode_points(xy, n, m_data);
+             on_add_points(xy, n, m_format.stride());
+             current_count() += n;
+         }
+
+         void multipoint_add_locations(const double* x, const double* y, const std::size_t n) {
+             encode_points(x, y, n, m_data);
+             on_add_points(x, y, n);
+             current_count() += n;
+         }
+
+         std::string multipoint_finish() {
+             if (close()) {
+                 return take_data();
+             }
+             return std::string{};
+         }
+
+         /**
+          * Finish the multipoint and append it to out. The internal buffer
+          * keeps its capacity, see linestring_finish(std::size_t, std::string&).
+          */
+         void multipoint_finish(std::string& out) {
+             if (close()) {
+                 append_data(out);
              }
+         }
 
-             return data;
+         /* MultiLineString */
+
+         void multilinestring_start() {
+             open_geometry(wkbMultiLineString);
+         }
+
+         void multilinestring_linestring_start() {
+             open_member(wkbLineString);
+             on_linestring_start();
+         }
+
+         void multilinestring_linestring_finish() {
+             on_linestring_finish();
+             close();
+         }
+
+         void multilinestring_add_location(const double x, const double y) {
+             multipolygon_add_location(x, y);
+         }
+
+         void multilinestring_add_location(const double x, const double y, const double c) {
+             multipolygon_add_location(x, y, c);
+         }
+
+         void multilinestring_add_location(const double x, const double y, const double z, const double m) {
+             multipolygon_add_location(x, y, z, m);
+         }
+
+         /**
+          * Add n points of the current linestring, see
+          * linestring_add_locations().
+          */
+         void multilinestring_add_locations(const double* xy, const std::size_t n) {
+             multipolygon_add_locations(xy, n);
+         }
+
+         void multilinestring_add_locations(const double* x, const double* y, const std::size_t n) {
+             multipolygon_add_locations(x, y, n);
+         }
+
+         template <typename TIterator>
+         void multilinestring_add_locations(TIterator first, TIterator last) {
+             multipolygon_add_locations(first, last);
+         }
+
+         template <typename TRange>
+         void multilinestring_add_locations(const TRange& points) {
+             multipolygon_add_locations(points);
+         }
+
+         std::string multilinestring_finish() {
+             if (close()) {
+                 return take_data();
+             }
+             return std::string{};
+         }
+
+         /**
+          * Finish the multilinestring and append it to out. The internal
+          * buffer keeps its capacity, see
+          * linestring_finish(std::size_t, std::string&).
+          */
+         void multilinestring_finish(std::string& out) {
+             if (close()) {
+                 append_data(out);
+             }
          }
 
          /* MultiPolygon */
 
          void multipolygon_start() {
-             m_data.clear();
-             m_polygons = 0;
-             m_multipolygon_size_offset = header(m_data, wkbMultiPolygon, true);
+             if (at_top_level()) {
+                 m_polygon_offsets.clear();
+             }
+             open_geometry(wkbMultiPolygon);
          }
 
          void multipolygon_polygon_start() {
-             ++m_polygons;
-             m_rings = 0;
-             m_polygon_size_offset = header(m_data, wkbPolygon, true);
+             if (m_explode && m_depth == 1) {
+                 m_polygon_offsets.push_back(m_data.size());
+             }
+             open_member(wkbPolygon);
+             on_polygon_start();
          }
 
          void multipolygon_polygon_finish() {
-             set_size(m_polygon_size_offset, m_rings);
+             close_polygon();
          }
 
          void multipolygon_outer_ring_start() {
-             ++m_rings;
-             m_points = 0;
-             m_ring_size_offset = m_data.size();
-             str_push(m_data, static_cast<uint32_t>(0));
+             open_ring();
          }
 
          void multipolygon_outer_ring_finish() {
-             set_size(m_ring_size_offset, m_points);
+             close_ring(m_outer_orientation);
          }
 
          void multipolygon_inner_ring_start() {
-             ++m_rings;
-             m_points = 0;
-             m_ring_size_offset = m_data.size();
-             str_push(m_data, static_cast<uint32_t>(0));
+             open_ring();
          }
 
          void multipolygon_inner_ring_finish() {
-             set_size(m_ring_size_offset, m_points);
+             close_ring(m_inner_orientation);
          }
 
          void multipolygon_add_location(const double x, const double y) {
-             str_push(m_data, x);
-             str_push(m_data, y);
-             ++m_points;
+             const double coords[2] = {x, y};
+             add_location(coords, 2);
+         }
+
+         void multipolygon_add_location(const double x, const double y, const double c) {
+             const double coords[3] = {x, y, c};
+             add_location(coords, 3);
+         }
+
+         void multipolygon_add_location(const double x, const double y, const double z, const double m) {
+             const double coords[4] = {x, y, z, m};
+             add_location(coords, 4);
+         }
+
+         /**
+          * Add n points of the current ring, see linestring_add_locations().
+          */
+         void multipolygon_add_locations(const double* xy, const std::size_t n) {
+             push_locations(xy, n);
+             current_count() += n;
+         }
+
+         void multipolygon_add_locations(const double* x, const double* y, const std::size_t n) {
+             push_locations(x, y, n);
+             current_count() += n;
+         }
+
+         template <typename TIterator>
+         void multipolygon_add_locations(TIterator first, TIterator last) {
+             current_count() += push_points(first, last);
+         }
+
+         template <typename TRange>
+         void multipolygon_add_locations(const TRange& points) {
+             current_count() += push_range(points);
          }
 
          std::string multipolygon_finish() {
-             set_size(m_multipolygon_size_offset, m_polygons);
-             std::string data;
+             if (close()) {
+                 return take_data();
+             }
+             return std::string{};
+         }
 
-             using std::swap;
-             swap(data, m_data);
+         /**
+          * Finish the multipolygon and append it to out. The internal buffer
+          * keeps its capacity, see linestring_finish(std::size_t, std::string&).
+          */
+         void multipolygon_finish(std::string& out) {
+             if (close()) {
+                 append_data(out);
+             }
+         }
 
-             if (m_out_type == out_type::hex) {
-                 return convert_to_hex(data);
+         /**
+          * Finish the multipolygon (explode mode only) and append each of
+          * its polygons as a standalone Polygon to batch. The members of a
+          * MultiPolygon are complete geometries with the same header
+          * (including the SRID of EWKB), so their bytes are copied as they
+          * are. offsets gets the end of each polygon in batch; if it is
+          * empty, the start of the first one is added before (the layout
+          * of Arrow binary columns, see validate()). Offsets count
+          * characters if the output type is HEX.
+          */
+         template <typename TOffset>
+         void multipolygon_finish(std::string& batch, std::vector<TOffset>& offsets) {
+             if (!m_explode || m_depth != 1) {
+                 throw wkb_error{"Only outermost MultiPolygons in explode mode can be split into polygons"};
+             }
+             close();
+             if (offsets.empty()) {
+                 offsets.push_back(static_cast<TOffset>(batch.size()));
+             }
+             if (m_polygon_offsets.empty()) {
+                 return;
              }
+             const std::size_t start = batch.size();
+             const std::size_t first = m_polygon_offsets.front();
+             batch.append(m_data, first, std::string::npos);
+             for (std::size_t i = 1; i < m_polygon_offsets.size(); ++i) {
+                 offsets.push_back(static_cast<TOffset>(start + m_polygon_offsets[i] - first));
+             }
+             offsets.push_back(static_cast<TOffset>(batch.size()));
+         }
 
-             return data;
+         /**
+          * Like multipolygon_finish(std::string&, std::vector<TOffset>&),
+          * but also append the whole MultiPolygon to out. It consists of
+          * its header and size followed by the bytes of the polygons.
+          */
+         template <typename TOffset>
+         void multipolygon_finish(std::string& batch, std::vector<TOffset>& offsets, std::string& out) {
+             multipolygon_finish(batch, offsets);
+             append_data(out);
          }
 
-    }; // class WKBWriter
+         /* GeometryCollection */
+
+         /**
+          * Start a GeometryCollection. Until geometrycollection_finish() is
+          * called, all geometries started with the *_start() methods
+          * (including other GeometryCollections) become members of the
+          * collection. Collections can be nested up to
+          * max_collection_depth levels.
+          */
+         void geometrycollection_start() {
+             open_geometry(wkbGeometryCollection);
+         }
+
+         /**
+          * Add a point to the open GeometryCollection. (make_point() always
+          * creates a separate geometry.)
+          */
+         void geometrycollection_add_point(const double x, const double y) {
+             const double coords[2] = {x, y};
+             add_point_member(coords, 2);
+         }
+
+         void geometrycollection_add_point(const double x, const double y, const double c) {
+             const double coords[3] = {x, y, c};
+             add_point_member(coords, 3);
+         }
+
+         void geometrycollection_add_point(const double x, const double y, const double z, const double m) {
+             const double coords[4] = {x, y, z, m};
+             add_point_member(coords, 4);
+         }
+
+         std::string geometrycollection_finish() {
+             if (close()) {
+                 return take_data();
+             }
+             return std::string{};
+         }
+
+         /**
+          * Finish the GeometryCollection and append it to out. The internal
+          * buffer keeps its capacity, see
+          * linestring_finish(std::size_t, std::string&).
+          */
+         void geometrycollection_finish(std::string& out) {
+             if (close()) {
+                 append_data(out);
+             }
+         }
+
+    }; // class GenericWKBWriter
+
+    template <typename TFormat, typename TBBox, typename TMetrics>
+    constexpr const std::size_t GenericWKBWriter<TFormat, TBBox, TMetrics>::max_header_chars;
+
+    template <typename TFormat, typename TBBox, typename TMetrics>
+    constexpr const std::size_t GenericWKBWriter<TFormat, TBBox, TMetrics>::max_point_size;
+
+    template <typename TFormat, typename TBBox, typename TMetrics>
+    constexpr const std::size_t GenericWKBWriter<TFormat, TBBox, TMetrics>::max_frames;
+
+    template <typename TFormat, typename TBBox, typename TMetrics>
+    constexpr const std::size_t GenericWKBWriter<TFormat, TBBox, TMetrics>::block_size;
+
+    /**
+     * WKB writer with output format chosen at compile time.
+     */
+    template <wkb_type TWkbType, out_type TOutType = out_type::binary, byte_order TByteOrder = native_byte_order,
+              dimensions TDimensions = dimensions::xy>
+    using BasicWKBWriter = GenericWKBWriter<static_format<TWkbType, TOutType, TByteOrder, TDimensions>>;
+
+    /**
+     * WKB writer with output format chosen at runtime.
+     */
+    using WKBWriter = GenericWKBWriter<dynamic_format>;
 
 } // namespace wkbhpp
 
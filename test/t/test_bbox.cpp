@@ -0,0 +1,227 @@
+#include "catch.hpp"
+
+#include <wkbhpp/bbox.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    std::vector<wkbhpp::detail::simd_level> supported_levels() {
+        std::vector<wkbhpp::detail::simd_level> levels;
+        for (const auto level : {wkbhpp::detail::simd_level::sse2,
+                                 wkbhpp::detail::simd_level::ssse3,
+                                 wkbhpp::detail::simd_level::avx2}) {
+            if (level <= wkbhpp::detail::cpu_simd_level()) {
+                levels.push_back(level);
+            }
+        }
+        return levels;
+    }
+
+    using bbox_writer = wkbhpp::GenericWKBWriter<wkbhpp::dynamic_format, wkbhpp::geometry_bbox>;
+    using detailed_writer = wkbhpp::GenericWKBWriter<wkbhpp::dynamic_format, wkbhpp::detailed_bbox>;
+
+} // anonymous namespace
+
+TEST_CASE("box") {
+    wkbhpp::box b;
+    REQUIRE(b.empty());
+    b.extend(1.0, 2.0);
+    REQUIRE_FALSE(b.empty());
+    REQUIRE(b == wkbhpp::box(1.0, 2.0, 1.0, 2.0));
+    b.extend(std::numeric_limits<double>::quiet_NaN(), -1.0);
+    REQUIRE(b == wkbhpp::box(1.0, -1.0, 1.0, 2.0));
+    b.extend(wkbhpp::box{});
+    REQUIRE(b == wkbhpp::box(1.0, -1.0, 1.0, 2.0));
+    b.extend(wkbhpp::box(-3.0, 0.0, 0.0, 5.0));
+    REQUIRE(b == wkbhpp::box(-3.0, -1.0, 1.0, 5.0));
+}
+
+TEST_CASE("SIMD min/max is identical to scalar min/max") {
+    std::mt19937 gen{23};
+    std::uniform_real_distribution<double> coord{-180.0, 180.0};
+    std::vector<double> data(4 * 50);
+    for (auto& c : data) {
+        c = coord(gen);
+    }
+    data[17] = std::numeric_limits<double>::quiet_NaN();
+
+    for (const auto level : supported_levels()) {
+        const auto minmax = wkbhpp::detail::minmax_finder(level);
+        for (std::size_t stride = 2; stride <= 4; ++stride) {
+            for (std::size_t n = 0; n < 50; ++n) {
+                double min_ref[2] = {100.0, 100.0};
+                double max_ref[2] = {-100.0, -100.0};
+                wkbhpp::detail::minmax_pairs_scalar(data.data(), n, stride, min_ref, max_ref);
+                double min[2] = {100.0, 100.0};
+                double max[2] = {-100.0, -100.0};
+                minmax(data.data(), n, stride, min, max);
+                REQUIRE(min[0] == min_ref[0]);
+                REQUIRE(min[1] == min_ref[1]);
+                REQUIRE(max[0] == max_ref[0]);
+                REQUIRE(max[1] == max_ref[1]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Bounding box of a linestring is computed while encoding") {
+    std::vector<double> xy;
+    std::vector<double> x;
+    std::vector<double> y;
+    for (int i = 0; i < 21; ++i) {
+        x.push_back(std::sin(i) * 10.0);
+        y.push_back(std::cos(i) * 5.0 + 1.0);
+        xy.push_back(x.back());
+        xy.push_back(y.back());
+    }
+    wkbhpp::box expected;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        expected.extend(x[i], y[i]);
+    }
+
+    bbox_writer writer{4326, wkbhpp::dynamic_format{wkbhpp::wkb_type::wkb, wkbhpp::out_type::hex}};
+    wkbhpp::WKBWriter plain{4326, wkbhpp::wkb_type::wkb, wkbhpp::out_type::hex};
+
+    SECTION("single locations") {
+        writer.linestring_start();
+        plain.linestring_start();
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            writer.linestring_add_location(x[i], y[i]);
+            plain.linestring_add_location(x[i], y[i]);
+        }
+        REQUIRE(writer.linestring_finish(x.size()) == plain.linestring_finish(x.size()));
+        REQUIRE(writer.bbox().geometry() == expected);
+    }
+
+    SECTION("interleaved array") {
+        writer.linestring_start();
+        writer.linestring_add_locations(xy.data(), x.size());
+        writer.linestring_finish(x.size());
+        REQUIRE(writer.bbox().geometry() == expected);
+    }
+
+    SECTION("separate arrays") {
+        writer.linestring_start();
+        writer.linestring_add_locations(x.data(), y.data(), x.size());
+        writer.linestring_finish(x.size());
+        REQUIRE(writer.bbox().geometry() == expected);
+    }
+
+    SECTION("range") {
+        std::vector<std::pair<double, double>> points;
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            points.emplace_back(x[i], y[i]);
+        }
+        writer.make_linestring(points);
+        REQUIRE(writer.bbox().geometry() == expected);
+    }
+
+    SECTION("the next geometry starts with an empty box") {
+        writer.linestring_start();
+        writer.linestring_add_locations(xy.data(), x.size());
+        writer.linestring_finish(x.size());
+        writer.linestring_start();
+        writer.linestring_add_location(1.0, 2.0);
+        writer.linestring_finish(1);
+        REQUIRE(writer.bbox().geometry() == wkbhpp::box(1.0, 2.0, 1.0, 2.0));
+    }
+}
+
+TEST_CASE("Bounding box of 3D points only looks at x and y") {
+    const std::vector<double> xyz{1.0, 2.0, 100.0, 3.0, -4.0, -100.0};
+    wkbhpp::GenericWKBWriter<wkbhpp::static_format<wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary,
+                                                   wkbhpp::native_byte_order, wkbhpp::dimensions::xyz>,
+                             wkbhpp::geometry_bbox> writer{4326};
+    writer.multipoint_start();
+    writer.multipoint_add_locations(xyz.data(), 2);
+    writer.multipoint_add_location(0.0, 0.0, 1000.0);
+    writer.multipoint_finish();
+    REQUIRE(writer.bbox().geometry() == wkbhpp::box(0.0, -4.0, 3.0, 2.0));
+}
+
+TEST_CASE("Bounding boxes of rings and polygons") {
+    detailed_writer writer{4326};
+    writer.multipolygon_start();
+    for (int p = 0; p < 2; ++p) {
+        const double offset = 10.0 * p;
+        writer.multipolygon_polygon_start();
+        writer.multipolygon_outer_ring_start();
+        writer.multipolygon_add_location(offset, 0.0);
+        writer.multipolygon_add_location(offset + 4.0, 0.0);
+        writer.multipolygon_add_location(offset + 4.0, 4.0);
+        writer.multipolygon_add_location(offset, 0.0);
+        writer.multipolygon_outer_ring_finish();
+        writer.multipolygon_inner_ring_start();
+        writer.multipolygon_add_location(offset + 1.0, 1.0);
+        writer.multipolygon_add_location(offset + 2.0, 1.0);
+        writer.multipolygon_add_location(offset + 2.0, 2.0);
+        writer.multipolygon_add_location(offset + 1.0, 1.0);
+        writer.multipolygon_inner_ring_finish();
+        writer.multipolygon_polygon_finish();
+    }
+    writer.multipolygon_finish();
+
+    const auto& bbox = writer.bbox();
+    REQUIRE(bbox.geometry() == wkbhpp::box(0.0, 0.0, 14.0, 4.0));
+    REQUIRE(bbox.rings().size() == 4);
+    REQUIRE(bbox.rings()[0] == wkbhpp::box(0.0, 0.0, 4.0, 4.0));
+    REQUIRE(bbox.rings()[1] == wkbhpp::box(1.0, 1.0, 2.0, 2.0));
+    REQUIRE(bbox.rings()[3] == wkbhpp::box(11.0, 1.0, 12.0, 2.0));
+    REQUIRE(bbox.polygons().size() == 2);
+    REQUIRE(bbox.polygons()[0] == wkbhpp::box(0.0, 0.0, 4.0, 4.0));
+    REQUIRE(bbox.polygons()[1] == wkbhpp::box(10.0, 0.0, 14.0, 4.0));
+
+    writer.polygon_start();
+    writer.polygon_outer_ring_start();
+    writer.polygon_add_location(5.0, 5.0);
+    writer.polygon_outer_ring_finish();
+    writer.polygon_finish();
+    REQUIRE(bbox.rings().size() == 1);
+    REQUIRE(bbox.polygons().size() == 1);
+    REQUIRE(bbox.geometry() == wkbhpp::box(5.0, 5.0, 5.0, 5.0));
+}
+
+TEST_CASE("Bounding box of a GeometryCollection covers all members") {
+    detailed_writer writer{4326};
+    writer.geometrycollection_start();
+    writer.geometrycollection_add_point(-1.0, 7.0);
+    writer.polygon_start();
+    writer.polygon_outer_ring_start();
+    writer.polygon_add_location(0.0, 0.0);
+    writer.polygon_add_location(3.0, 3.0);
+    writer.polygon_outer_ring_finish();
+    REQUIRE(writer.polygon_finish().empty());
+    writer.geometrycollection_finish();
+    REQUIRE(writer.bbox().geometry() == wkbhpp::box(-1.0, 0.0, 3.0, 7.0));
+    REQUIRE(writer.bbox().polygons().size() == 1);
+    REQUIRE(writer.bbox().polygons()[0] == wkbhpp::box(0.0, 0.0, 3.0, 3.0));
+}
+
+TEST_CASE("Detailed bounding boxes of linestrings") {
+    detailed_writer writer{4326};
+    writer.linestring_start();
+    writer.linestring_add_location(1.0, 2.0);
+    writer.linestring_add_location(-3.0, 5.0);
+    writer.linestring_finish(2);
+    REQUIRE(writer.bbox().geometry() == wkbhpp::box(-3.0, 2.0, 1.0, 5.0));
+    REQUIRE(writer.bbox().rings().empty());
+
+    writer.multilinestring_start();
+    writer.multilinestring_linestring_start();
+    writer.multilinestring_add_location(0.0, 0.0);
+    writer.multilinestring_add_location(1.0, 1.0);
+    writer.multilinestring_linestring_finish();
+    writer.multilinestring_linestring_start();
+    writer.multilinestring_add_location(4.0, -2.0);
+    writer.multilinestring_add_location(5.0, 0.0);
+    writer.multilinestring_linestring_finish();
+    writer.multilinestring_finish();
+    REQUIRE(writer.bbox().geometry() == wkbhpp::box(0.0, -2.0, 5.0, 1.0));
+}
@@ -0,0 +1,300 @@
+#include "catch.hpp"
+
+#include <wkbhpp/clip.hpp>
+#include <wkbhpp/validate.hpp>
+#include <wkbhpp/wkbview.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::vector<double> xy_of(const wkbhpp::point_sequence& points) {
+        std::vector<double> result;
+        for (const auto& p : points) {
+            result.push_back(p.x());
+            result.push_back(p.y());
+        }
+        return result;
+    }
+
+    double ring_area(const wkbhpp::point_sequence& points) {
+        double sum = 0.0;
+        for (std::size_t i = 1; i < points.size(); ++i) {
+            sum += points[i - 1].x() * points[i].y() - points[i].x() * points[i - 1].y();
+        }
+        return sum / 2;
+    }
+
+    const wkbhpp::box tile{0.0, 0.0, 10.0, 10.0};
+
+} // anonymous namespace
+
+TEST_CASE("Linestrings inside the clip box are written unchanged") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    const std::vector<double> line{1.0, 1.0, 5.0, 2.0, 10.0, 10.0};
+    clipper.linestring_start();
+    clipper.linestring_add_locations(line.data(), 3);
+    const std::string wkb = clipper.linestring_finish();
+
+    writer.linestring_start();
+    writer.linestring_add_locations(line.data(), 3);
+    REQUIRE(wkb == writer.linestring_finish(3));
+}
+
+TEST_CASE("Linestrings outside the clip box are dropped") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    clipper.linestring_start();
+    clipper.linestring_add_location(11.0, 1.0);
+    clipper.linestring_add_location(20.0, 5.0);
+    REQUIRE(clipper.linestring_finish().empty());
+
+    // touching a corner is not enough
+    std::string out;
+    clipper.linestring_start();
+    clipper.linestring_add_location(-1.0, 1.0);
+    clipper.linestring_add_location(1.0, -1.0);
+    REQUIRE_FALSE(clipper.linestring_finish(out));
+    REQUIRE(out.empty());
+}
+
+TEST_CASE("A linestring crossing the clip box is cut at its edges") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    clipper.linestring_start();
+    clipper.linestring_add_location(-5.0, 5.0);
+    clipper.linestring_add_location(5.0, 5.0);
+    clipper.linestring_add_location(5.0, 15.0);
+    const std::string wkb = clipper.linestring_finish();
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(view.type() == wkbhpp::geometry_type::linestring);
+    REQUIRE(xy_of(view.points()) == (std::vector<double>{0.0, 5.0, 5.0, 5.0, 5.0, 10.0}));
+}
+
+TEST_CASE("Repeated points are dropped from clipped linestrings") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    clipper.linestring_start();
+    clipper.linestring_add_location(5.0, 5.0);
+    clipper.linestring_add_location(5.0, 5.0);
+    clipper.linestring_add_location(15.0, 5.0);
+    REQUIRE(xy_of(wkbhpp::WKBView{clipper.linestring_finish()}.points()) ==
+            (std::vector<double>{5.0, 5.0, 10.0, 5.0}));
+
+    clipper.linestring_start();
+    clipper.linestring_add_location(-5.0, 5.0);
+    clipper.linestring_add_location(5.0, 5.0);
+    clipper.linestring_add_location(5.0, 5.0);
+    clipper.linestring_add_location(5.0, 15.0);
+    REQUIRE(xy_of(wkbhpp::WKBView{clipper.linestring_finish()}.points()) ==
+            (std::vector<double>{0.0, 5.0, 5.0, 5.0, 5.0, 10.0}));
+}
+
+TEST_CASE("A linestring leaving and reentering the clip box becomes a MultiLineString") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    clipper.linestring_start();
+    clipper.linestring_add_location(2.0, 5.0);
+    clipper.linestring_add_location(2.0, 20.0);
+    clipper.linestring_add_location(8.0, 20.0);
+    clipper.linestring_add_location(8.0, 5.0);
+    const std::string wkb = clipper.linestring_finish();
+    REQUIRE(wkbhpp::validate(wkb.data(), wkb.size()) == wkbhpp::wkb_status::ok);
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(view.type() == wkbhpp::geometry_type::multilinestring);
+    std::vector<std::vector<double>> pieces;
+    for (const auto& member : view.geometries()) {
+        pieces.push_back(xy_of(member.points()));
+    }
+    REQUIRE(pieces.size() == 2);
+    REQUIRE(pieces[0] == (std::vector<double>{2.0, 5.0, 2.0, 10.0}));
+    REQUIRE(pieces[1] == (std::vector<double>{8.0, 10.0, 8.0, 5.0}));
+}
+
+TEST_CASE("Pieces of all members of a MultiLineString are collected") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    clipper.multilinestring_start();
+    clipper.multilinestring_linestring_start();
+    clipper.multilinestring_add_location(20.0, 20.0);
+    clipper.multilinestring_add_location(30.0, 20.0);
+    clipper.multilinestring_linestring_finish();
+    clipper.multilinestring_linestring_start();
+    clipper.multilinestring_add_location(-1.0, 1.0);
+    clipper.multilinestring_add_location(11.0, 1.0);
+    clipper.multilinestring_linestring_finish();
+    const std::string wkb = clipper.multilinestring_finish();
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(view.type() == wkbhpp::geometry_type::multilinestring);
+    REQUIRE(view.geometries().size() == 1);
+    REQUIRE(xy_of(view.geometries().begin()->points()) == (std::vector<double>{0.0, 1.0, 10.0, 1.0}));
+
+    clipper.multilinestring_start();
+    clipper.multilinestring_linestring_start();
+    clipper.multilinestring_add_location(20.0, 20.0);
+    clipper.multilinestring_add_location(30.0, 20.0);
+    clipper.multilinestring_linestring_finish();
+    REQUIRE(clipper.multilinestring_finish().empty());
+}
+
+TEST_CASE("Polygon rings are clipped with the clip box") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    // square overlapping the upper right corner, with one hole inside
+    // and one outside the clip box
+    const std::vector<double> outer{5.0, 5.0, 15.0, 5.0, 15.0, 15.0, 5.0, 15.0, 5.0, 5.0};
+    const std::vector<double> inner1{6.0, 6.0, 6.0, 7.0, 7.0, 7.0, 7.0, 6.0, 6.0, 6.0};
+    const std::vector<double> inner2{12.0, 12.0, 12.0, 13.0, 13.0, 13.0, 13.0, 12.0, 12.0, 12.0};
+    clipper.polygon_start();
+    clipper.polygon_outer_ring_start();
+    clipper.polygon_add_locations(outer.data(), 5);
+    clipper.polygon_outer_ring_finish();
+    clipper.polygon_inner_ring_start();
+    clipper.polygon_add_locations(inner1.data(), 5);
+    clipper.polygon_inner_ring_finish();
+    clipper.polygon_inner_ring_start();
+    clipper.polygon_add_locations(inner2.data(), 5);
+    clipper.polygon_inner_ring_finish();
+    const std::string wkb = clipper.polygon_finish();
+    REQUIRE(wkbhpp::validate(wkb.data(), wkb.size()) == wkbhpp::wkb_status::ok);
+
+    const auto rings = wkbhpp::WKBView{wkb}.rings();
+    REQUIRE(rings.size() == 2);
+    auto it = rings.begin();
+    // the clipped ring starts where it enters the box
+    REQUIRE(xy_of(*it) == (std::vector<double>{5.0, 10.0, 5.0, 5.0, 10.0, 5.0, 10.0, 10.0, 5.0, 10.0}));
+    ++it;
+    REQUIRE(xy_of(*it) == inner1);
+
+    // a polygon outside the box is dropped with its holes
+    clipper.polygon_start();
+    clipper.polygon_outer_ring_start();
+    clipper.polygon_add_locations(inner2.data(), 5);
+    clipper.polygon_outer_ring_finish();
+    clipper.polygon_inner_ring_start();
+    clipper.polygon_add_locations(inner1.data(), 5);
+    clipper.polygon_inner_ring_finish();
+    std::string out;
+    REQUIRE_FALSE(clipper.polygon_finish(out));
+    REQUIRE(out.empty());
+}
+
+TEST_CASE("A hole crossing the clip box becomes part of the outer ring") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    const std::vector<double> outer{5.0, 5.0, 15.0, 5.0, 15.0, 15.0, 5.0, 15.0, 5.0, 5.0};
+    const std::vector<double> inner{8.0, 8.0, 8.0, 12.0, 12.0, 12.0, 12.0, 8.0, 8.0, 8.0};
+    clipper.polygon_start();
+    clipper.polygon_outer_ring_start();
+    clipper.polygon_add_locations(outer.data(), 5);
+    clipper.polygon_outer_ring_finish();
+    clipper.polygon_inner_ring_start();
+    clipper.polygon_add_locations(inner.data(), 5);
+    clipper.polygon_inner_ring_finish();
+    const std::string wkb = clipper.polygon_finish();
+    REQUIRE(wkbhpp::validate(wkb.data(), wkb.size()) == wkbhpp::wkb_status::ok);
+
+    // the hole does not run along the edge of the box next to the shell
+    const auto rings = wkbhpp::WKBView{wkb}.rings();
+    REQUIRE(rings.size() == 1);
+    const auto ring = *rings.begin();
+    REQUIRE(xy_of(ring).size() == 2 * 7);
+    REQUIRE(ring_area(ring) == Approx(25.0 - 4.0));
+}
+
+TEST_CASE("A polygon entering the clip box twice becomes a MultiPolygon") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    // upside down U with its legs in the box
+    const std::vector<double> ring{2.0, 5.0, 3.0, 5.0, 3.0, 15.0, 7.0, 15.0, 7.0, 5.0,
+                                   8.0, 5.0, 8.0, 20.0, 2.0, 20.0, 2.0, 5.0};
+    clipper.polygon_start();
+    clipper.polygon_outer_ring_start();
+    clipper.polygon_add_locations(ring.data(), 9);
+    clipper.polygon_outer_ring_finish();
+    const std::string wkb = clipper.polygon_finish();
+    REQUIRE(wkbhpp::validate(wkb.data(), wkb.size()) == wkbhpp::wkb_status::ok);
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(view.type() == wkbhpp::geometry_type::multipolygon);
+    REQUIRE(view.geometries().size() == 2);
+    for (const auto& polygon : view.geometries()) {
+        const auto leg = *polygon.rings().begin();
+        REQUIRE(leg.size() == 5);
+        REQUIRE(ring_area(leg) == Approx(5.0));
+    }
+}
+
+TEST_CASE("A ring around the clip box becomes the clip box") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    const std::vector<double> ring{-5.0, -5.0, 15.0, -5.0, 15.0, 15.0, -5.0, 15.0, -5.0, -5.0};
+    clipper.polygon_start();
+    clipper.polygon_outer_ring_start();
+    clipper.polygon_add_locations(ring.data(), 5);
+    clipper.polygon_outer_ring_finish();
+    const std::string wkb = clipper.polygon_finish();
+
+    const auto points = *wkbhpp::WKBView{wkb}.rings().begin();
+    REQUIRE(points.size() == 5);
+    for (const auto& p : points) {
+        REQUIRE((p.x() == 0.0 || p.x() == 10.0));
+        REQUIRE((p.y() == 0.0 || p.y() == 10.0));
+    }
+}
+
+TEST_CASE("MultiPolygons keep only the polygons inside the clip box") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Clipper<wkbhpp::WKBWriter> clipper{writer, tile};
+
+    const std::vector<double> inside{1.0, 1.0, 2.0, 1.0, 2.0, 2.0, 1.0, 1.0};
+    const std::vector<double> outside{21.0, 1.0, 22.0, 1.0, 22.0, 2.0, 21.0, 1.0};
+    clipper.multipolygon_start();
+    for (const auto* ring : {&outside, &inside, &outside}) {
+        clipper.multipolygon_polygon_start();
+        clipper.multipolygon_outer_ring_start();
+        clipper.multipolygon_add_locations(ring->data(), 4);
+        clipper.multipolygon_outer_ring_finish();
+        clipper.multipolygon_polygon_finish();
+    }
+    const std::string wkb = clipper.multipolygon_finish();
+    REQUIRE(wkbhpp::validate(wkb.data(), wkb.size()) == wkbhpp::wkb_status::ok);
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(view.geometries().size() == 1);
+    REQUIRE(xy_of(*view.geometries().begin()->rings().begin()) == inside);
+}
+
+TEST_CASE("Clipping interpolates Z") {
+    wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary, wkbhpp::native_byte_order,
+                           wkbhpp::dimensions::xyz> writer{4326};
+    wkbhpp::Clipper<decltype(writer)> clipper{writer, tile};
+
+    clipper.linestring_start();
+    clipper.linestring_add_location(5.0, 5.0, 100.0);
+    clipper.linestring_add_location(15.0, 5.0, 200.0);
+    const std::string wkb = clipper.linestring_finish();
+
+    const auto points = wkbhpp::WKBView{wkb}.points();
+    REQUIRE(points.size() == 2);
+    REQUIRE(points[1].x() == 10.0);
+    REQUIRE(points[1].z() == Approx(150.0));
+
+    REQUIRE_THROWS_AS(clipper.linestring_add_location(1.0, 2.0), const wkbhpp::wkb_error&);
+}
@@ -0,0 +1,150 @@
+#include "catch.hpp"
+
+#include <wkbhpp/hex.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::string random_bytes(std::size_t size, unsigned int seed) {
+        std::mt19937 gen{seed};
+        std::uniform_int_distribution<int> dist{0, 255};
+        std::string data;
+        for (std::size_t i = 0; i < size; ++i) {
+            data += static_cast<char>(dist(gen));
+        }
+        return data;
+    }
+
+    std::vector<wkbhpp::detail::simd_level> supported_levels() {
+        std::vector<wkbhpp::detail::simd_level> levels;
+        for (const auto level : {wkbhpp::detail::simd_level::sse2,
+                                 wkbhpp::detail::simd_level::ssse3,
+                                 wkbhpp::detail::simd_level::avx2}) {
+            if (level <= wkbhpp::detail::cpu_simd_level()) {
+                levels.push_back(level);
+            }
+        }
+        return levels;
+    }
+
+} // anonymous namespace
+
+TEST_CASE("convert_to_hex") {
+    const std::string data{"\x01\x02\x00\x00\x20\xE6\x10\xab\xff", 9};
+    REQUIRE(wkbhpp::convert_to_hex(data) == "0102000020E610ABFF");
+    REQUIRE(wkbhpp::convert_to_hex(data, wkbhpp::hex_case::lower) == "0102000020e610abff");
+    REQUIRE(wkbhpp::convert_to_hex("").empty());
+}
+
+TEST_CASE("append_hex appends to existing content") {
+    std::string out{"x"};
+    wkbhpp::append_hex(out, std::string{"\x0f\xf0", 2});
+    REQUIRE(out == "x0FF0");
+}
+
+TEST_CASE("SIMD HEX encoders are byte-for-byte identical to the scalar encoder") {
+    const std::string data = random_bytes(1031, 42);
+
+    for (const auto hcase : {wkbhpp::hex_case::upper, wkbhpp::hex_case::lower}) {
+        for (const auto level : supported_levels()) {
+            const auto encode = wkbhpp::detail::hex_encoder(level);
+            // all sizes around the block sizes and some unaligned starts
+            for (std::size_t size = 0; size < 200; ++size) {
+                for (std::size_t start = 0; start < 3; ++start) {
+                    const auto* in = reinterpret_cast<const unsigned char*>(data.data()) + start;
+                    std::string expected(2 * size, ' ');
+                    std::string actual(2 * size, ' ');
+                    wkbhpp::detail::hex_encode_scalar(&expected[0], in, size, hcase);
+                    encode(&actual[0], in, size, hcase);
+                    REQUIRE(actual == expected);
+                }
+            }
+
+            std::string expected(2 * data.size(), ' ');
+            std::string actual(2 * data.size(), ' ');
+            wkbhpp::detail::hex_encode_scalar(&expected[0], reinterpret_cast<const unsigned char*>(data.data()), data.size(), hcase);
+            encode(&actual[0], reinterpret_cast<const unsigned char*>(data.data()), data.size(), hcase);
+            REQUIRE(actual == expected);
+        }
+    }
+}
+
+TEST_CASE("convert_from_hex") {
+    REQUIRE(wkbhpp::convert_from_hex("0102000020E610abFF") == std::string("\x01\x02\x00\x00\x20\xE6\x10\xab\xff", 9));
+    REQUIRE(wkbhpp::convert_from_hex("").empty());
+
+    const std::string data = random_bytes(1000, 7);
+    REQUIRE(wkbhpp::convert_from_hex(wkbhpp::convert_to_hex(data)) == data);
+    REQUIRE(wkbhpp::convert_from_hex(wkbhpp::convert_to_hex(data, wkbhpp::hex_case::lower)) == data);
+}
+
+TEST_CASE("convert_from_hex reports odd length") {
+    try {
+        wkbhpp::convert_from_hex("0102030");
+        FAIL("expected hex_error");
+    } catch (const wkbhpp::hex_error& e) {
+        REQUIRE(e.position() == 6);
+    }
+}
+
+TEST_CASE("convert_from_hex reports the first invalid character") {
+    const std::string hex = wkbhpp::convert_to_hex(random_bytes(300, 3));
+    for (const std::size_t pos : {std::size_t(0), std::size_t(1), std::size_t(31), std::size_t(32),
+                                  std::size_t(63), std::size_t(64), std::size_t(100), std::size_t(599)}) {
+        for (const char c : {'g', 'G', ' ', '/', ':', '@', '`', '\xb0'}) {
+            std::string bad{hex};
+            bad[pos] = c;
+            if (pos + 5 < bad.size()) {
+                bad[pos + 5] = 'x';
+            }
+            try {
+                wkbhpp::convert_from_hex(bad);
+                FAIL("expected hex_error");
+            } catch (const wkbhpp::hex_error& e) {
+                REQUIRE(e.position() == pos);
+            }
+        }
+    }
+}
+
+TEST_CASE("convert_from_hex_inplace decodes into the same buffer") {
+    const std::string data = random_bytes(777, 11);
+    std::string buffer = wkbhpp::convert_to_hex(data);
+    const char* address = buffer.data();
+    wkbhpp::convert_from_hex_inplace(buffer);
+    REQUIRE(buffer == data);
+    REQUIRE(buffer.data() == address);
+}
+
+TEST_CASE("SIMD HEX decoders are identical to the scalar decoder") {
+    const std::string data = random_bytes(1031, 5);
+    const std::string hex = wkbhpp::convert_to_hex(data, wkbhpp::hex_case::lower);
+    const auto* in = reinterpret_cast<const unsigned char*>(hex.data());
+
+    for (const auto level : supported_levels()) {
+        const auto decode = wkbhpp::detail::hex_decoder(level);
+        for (std::size_t size = 0; size < 200; ++size) {
+            std::string out(size, ' ');
+            REQUIRE(decode(&out[0], in, size) == wkbhpp::detail::hex_input_valid);
+            REQUIRE(out == data.substr(0, size));
+        }
+
+        std::string out(data.size(), ' ');
+        REQUIRE(decode(&out[0], in, data.size()) == wkbhpp::detail::hex_input_valid);
+        REQUIRE(out == data);
+
+        // in-place
+        std::string buffer{hex};
+        REQUIRE(decode(&buffer[0], reinterpret_cast<const unsigned char*>(buffer.data()), data.size()) == wkbhpp::detail::hex_input_valid);
+        REQUIRE(buffer.substr(0, data.size()) == data);
+
+        for (std::size_t pos = 0; pos < 200; pos += 7) {
+            std::string bad{hex};
+            bad[pos] = 'z';
+            REQUIRE(decode(&out[0], reinterpret_cast<const unsigned char*>(bad.data()), data.size()) == pos);
+        }
+    }
+}
@@ -0,0 +1,163 @@
+#include "catch.hpp"
+
+#include <wkbhpp/metrics.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using metrics_writer = wkbhpp::GenericWKBWriter<wkbhpp::dynamic_format, wkbhpp::no_bbox, wkbhpp::planar_metrics>;
+
+    template <typename TWriter>
+    void square(TWriter& writer, double x, double y, double size, bool ccw) {
+        if (ccw) {
+            writer.multipolygon_add_location(x, y);
+            writer.multipolygon_add_location(x + size, y);
+            writer.multipolygon_add_location(x + size, y + size);
+            writer.multipolygon_add_location(x, y + size);
+        } else {
+            writer.multipolygon_add_location(x, y);
+            writer.multipolygon_add_location(x, y + size);
+            writer.multipolygon_add_location(x + size, y + size);
+            writer.multipolygon_add_location(x + size, y);
+        }
+        writer.multipolygon_add_location(x, y);
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Area, perimeter and centroid of a polygon with a hole") {
+    metrics_writer writer{4326};
+
+    for (const bool ccw : {true, false}) {
+        writer.polygon_start();
+        writer.polygon_outer_ring_start();
+        square(writer, 0.0, 0.0, 4.0, ccw);
+        writer.polygon_outer_ring_finish();
+        writer.polygon_inner_ring_start();
+        square(writer, 1.0, 1.0, 1.0, ccw);
+        writer.polygon_inner_ring_finish();
+        writer.polygon_finish();
+
+        const auto& metrics = writer.metrics();
+        REQUIRE(metrics.area() == Approx(15.0));
+        REQUIRE(metrics.length() == Approx(20.0));
+        REQUIRE(metrics.ring_areas().size() == 2);
+        REQUIRE(metrics.ring_areas()[0] == Approx(ccw ? 16.0 : -16.0));
+        REQUIRE(metrics.ring_areas()[1] == Approx(ccw ? 1.0 : -1.0));
+        REQUIRE(metrics.centroid().x == Approx((16.0 * 2.0 - 1.0 * 1.5) / 15.0));
+        REQUIRE(metrics.centroid().y == Approx((16.0 * 2.0 - 1.0 * 1.5) / 15.0));
+    }
+}
+
+TEST_CASE("Area of a multipolygon far from the origin") {
+    metrics_writer writer{4326};
+    writer.multipolygon_start();
+    for (int p = 0; p < 2; ++p) {
+        writer.multipolygon_polygon_start();
+        writer.multipolygon_outer_ring_start();
+        square(writer, 1e7 + 10.0 * p, 1e7, 2.0, true);
+        writer.multipolygon_outer_ring_finish();
+        writer.multipolygon_polygon_finish();
+    }
+    writer.multipolygon_finish();
+    REQUIRE(writer.metrics().area() == 8.0);
+    REQUIRE(writer.metrics().centroid().x == Approx(1e7 + 6.0));
+    REQUIRE(writer.metrics().centroid().y == Approx(1e7 + 1.0));
+}
+
+TEST_CASE("Length and centroid of linestrings") {
+    metrics_writer writer{4326};
+
+    SECTION("single locations") {
+        writer.linestring_start();
+        writer.linestring_add_location(0.0, 0.0);
+        writer.linestring_add_location(3.0, 4.0);
+        writer.linestring_finish(2);
+    }
+
+    SECTION("bulk") {
+        const std::vector<double> xy{0.0, 0.0, 3.0, 4.0};
+        writer.linestring_start();
+        writer.linestring_add_locations(xy.data(), 2);
+        writer.linestring_finish(2);
+    }
+
+    SECTION("separate arrays") {
+        const std::vector<double> x{0.0, 3.0};
+        const std::vector<double> y{0.0, 4.0};
+        writer.linestring_start();
+        writer.linestring_add_locations(x.data(), y.data(), 2);
+        writer.linestring_finish(2);
+    }
+
+    REQUIRE(writer.metrics().length() == Approx(5.0));
+    REQUIRE(writer.metrics().area() == 0.0);
+    REQUIRE(writer.metrics().centroid().x == Approx(1.5));
+    REQUIRE(writer.metrics().centroid().y == Approx(2.0));
+}
+
+TEST_CASE("Linestrings of a MultiLineString are not connected") {
+    metrics_writer writer{4326};
+    writer.multilinestring_start();
+    for (const double x : {0.0, 5.0}) {
+        writer.multilinestring_linestring_start();
+        writer.multilinestring_add_location(x, 0.0);
+        writer.multilinestring_add_location(x + 1.0, 0.0);
+        writer.multilinestring_linestring_finish();
+    }
+    writer.multilinestring_finish();
+    REQUIRE(writer.metrics().length() == Approx(2.0));
+    REQUIRE(writer.metrics().centroid().x == Approx(3.0));
+}
+
+TEST_CASE("Centroid of a MultiPoint is the mean of its points") {
+    metrics_writer writer{4326};
+    writer.multipoint_start();
+    writer.multipoint_add_location(0.0, 0.0);
+    writer.multipoint_add_location(2.0, 6.0);
+    writer.multipoint_finish();
+    REQUIRE(writer.metrics().length() == 0.0);
+    REQUIRE(writer.metrics().centroid().x == Approx(1.0));
+    REQUIRE(writer.metrics().centroid().y == Approx(3.0));
+
+    writer.multipoint_start();
+    writer.multipoint_finish();
+    REQUIRE(std::isnan(writer.metrics().centroid().x));
+}
+
+TEST_CASE("Metrics of 3D geometries only look at x and y") {
+    wkbhpp::GenericWKBWriter<wkbhpp::static_format<wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary,
+                                                   wkbhpp::native_byte_order, wkbhpp::dimensions::xyz>,
+                             wkbhpp::no_bbox, wkbhpp::planar_metrics> writer{4326};
+    const std::vector<double> xyz{0.0, 0.0, 100.0, 3.0, 4.0, -100.0};
+    writer.linestring_start();
+    writer.linestring_add_locations(xyz.data(), 2);
+    writer.linestring_finish(2);
+    REQUIRE(writer.metrics().length() == Approx(5.0));
+}
+
+TEST_CASE("Spherical metrics") {
+    wkbhpp::GenericWKBWriter<wkbhpp::dynamic_format, wkbhpp::geometry_bbox, wkbhpp::spherical_metrics> writer{4326};
+    const double r = wkbhpp::spherical_calc::earth_radius;
+    const double one_degree = 3.14159265358979323846 / 180.0;
+
+    writer.linestring_start();
+    writer.linestring_add_location(0.0, 0.0);
+    writer.linestring_add_location(1.0, 0.0);
+    writer.linestring_finish(2);
+    REQUIRE(writer.metrics().length() == Approx(r * one_degree));
+
+    writer.polygon_start();
+    writer.polygon_outer_ring_start();
+    square(writer, 0.0, 0.0, 1.0, true);
+    writer.polygon_outer_ring_finish();
+    writer.polygon_finish();
+    REQUIRE(writer.metrics().area() == Approx(r * r * one_degree * std::sin(one_degree)));
+    REQUIRE(writer.metrics().ring_areas()[0] > 0.0);
+    REQUIRE(writer.metrics().centroid().x == Approx(0.5));
+    REQUIRE(writer.bbox().geometry() == wkbhpp::box(0.0, 0.0, 1.0, 1.0));
+}
@@ -0,0 +1,111 @@
+#include "catch.hpp"
+
+#include <wkbhpp/multi_level.hpp>
+#include <wkbhpp/simplify.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // wobbly circle
+    std::vector<double> make_ring(double cx, std::size_t n) {
+        std::vector<double> ring;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double a = 2 * 3.14159265358979323846 * i / n;
+            const double r = 10.0 + std::sin(a * 17) * 0.3 + std::sin(a * 3) * 2.0;
+            ring.push_back(cx + r * std::cos(a));
+            ring.push_back(r * std::sin(a));
+        }
+        ring.push_back(ring[0]);
+        ring.push_back(ring[1]);
+        return ring;
+    }
+
+    const std::vector<double> tolerances{0.0, 0.05, 0.5, 2.0, 50.0};
+
+} // anonymous namespace
+
+TEST_CASE("Each level of a MultiLevelWriter equals a simplification with its tolerance") {
+    const wkbhpp::WKBWriter prototype{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex};
+
+    for (const auto algorithm : {wkbhpp::simplify_algorithm::douglas_peucker, wkbhpp::simplify_algorithm::visvalingam}) {
+        wkbhpp::MultiLevelWriter<wkbhpp::WKBWriter> levels{prototype, tolerances, algorithm};
+        REQUIRE(levels.levels() == tolerances.size());
+
+        const auto outer = make_ring(0.0, 500);
+        const auto line = make_ring(30.0, 300);
+
+        std::vector<std::string> out;
+        for (int round = 0; round < 2; ++round) {
+            out.clear();
+            levels.multipolygon_start();
+            levels.multipolygon_polygon_start();
+            levels.multipolygon_outer_ring_start();
+            levels.multipolygon_add_locations(outer.data(), outer.size() / 2);
+            levels.multipolygon_outer_ring_finish();
+            levels.multipolygon_polygon_finish();
+            levels.multipolygon_finish(out);
+
+            levels.linestring_start();
+            for (std::size_t i = 0; i < line.size(); i += 2) {
+                levels.linestring_add_location(line[i], line[i + 1]);
+            }
+            levels.linestring_finish(out);
+        }
+        REQUIRE(out.size() == tolerances.size());
+
+        for (std::size_t i = 0; i < tolerances.size(); ++i) {
+            wkbhpp::WKBWriter writer{prototype};
+            wkbhpp::Simplifier<wkbhpp::WKBWriter> simplifier{writer, tolerances[i], algorithm};
+            std::string expected;
+            simplifier.multipolygon_start();
+            simplifier.multipolygon_polygon_start();
+            simplifier.multipolygon_outer_ring_start();
+            simplifier.multipolygon_add_locations(outer.data(), outer.size() / 2);
+            simplifier.multipolygon_outer_ring_finish();
+            simplifier.multipolygon_polygon_finish();
+            simplifier.multipolygon_finish(expected);
+            simplifier.linestring_start();
+            simplifier.linestring_add_locations(line.data(), line.size() / 2);
+            simplifier.linestring_finish(expected);
+            REQUIRE(out[i] == expected);
+        }
+
+        // higher tolerances give smaller outputs
+        for (std::size_t i = 1; i < tolerances.size(); ++i) {
+            REQUIRE(out[i].size() <= out[i - 1].size());
+        }
+    }
+}
+
+TEST_CASE("MultiLevelWriter with polygons and multilinestrings") {
+    const wkbhpp::WKBWriter prototype{4326};
+    wkbhpp::MultiLevelWriter<wkbhpp::WKBWriter> levels{prototype, {0.0, 100.0}};
+    const auto ring = make_ring(0.0, 100);
+
+    std::vector<std::string> polygons;
+    levels.polygon_start();
+    levels.polygon_outer_ring_start();
+    levels.polygon_add_locations(ring.data(), ring.size() / 2);
+    levels.polygon_outer_ring_finish();
+    levels.polygon_finish(polygons);
+    REQUIRE(polygons.size() == 2);
+    // the ring keeps its minimum of 5 points (see douglas_peucker_ranks())
+    REQUIRE(polygons[1].size() == 1 + 4 + 4 + 4 + 5 * 16);
+
+    std::vector<std::string> lines;
+    levels.multilinestring_start();
+    for (int i = 0; i < 2; ++i) {
+        levels.multilinestring_linestring_start();
+        levels.multilinestring_add_locations(ring.data(), ring.size() / 2);
+        levels.multilinestring_linestring_finish();
+    }
+    levels.multilinestring_finish(lines);
+    REQUIRE(lines[0].size() > lines[1].size());
+    REQUIRE(lines[1].size() == 1 + 4 + 4 + 2 * (1 + 4 + 4 + 2 * 16));
+
+    REQUIRE_THROWS_AS((wkbhpp::MultiLevelWriter<wkbhpp::WKBWriter>{prototype, {}}), const wkbhpp::wkb_error&);
+}
@@ -0,0 +1,185 @@
+#include "catch.hpp"
+
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <array>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    struct coordinates {
+        double x;
+        double y;
+    };
+
+    std::istream& operator>>(std::istream& in, coordinates& c) {
+        return in >> c.x >> c.y;
+    }
+
+    struct coordinates_with_constructor {
+        double x = 0.0;
+        double y = 0.0;
+
+        coordinates_with_constructor(double cx, double cy) :
+            x(cx),
+            y(cy) {
+        }
+    };
+
+    struct swapped_coordinates {
+        double y;
+        double x;
+    };
+
+    struct float_coordinates {
+        float x;
+        float y;
+    };
+
+    class point_with_accessors {
+
+        double m_x;
+        double m_y;
+
+    public:
+
+        point_with_accessors(double x, double y) :
+            m_x(x),
+            m_y(y) {
+        }
+
+        double x() const {
+            return m_x;
+        }
+
+        double y() const {
+            return m_y;
+        }
+
+    };
+
+    struct lonlat {
+        double lon;
+        double lat;
+    };
+
+} // anonymous namespace
+
+namespace wkbhpp {
+
+    template <>
+    struct point_traits<lonlat> {
+
+        static constexpr const bool xy_layout = true;
+
+        static double x(const lonlat& point) {
+            return point.lon;
+        }
+
+        static double y(const lonlat& point) {
+            return point.lat;
+        }
+
+    };
+
+} // namespace wkbhpp
+
+static_assert(wkbhpp::point_traits<coordinates>::xy_layout, "plain struct of two doubles");
+static_assert(wkbhpp::point_traits<coordinates_with_constructor>::xy_layout, "constructors do not matter");
+static_assert(!wkbhpp::point_traits<swapped_coordinates>::xy_layout, "y before x");
+static_assert(!wkbhpp::point_traits<float_coordinates>::xy_layout, "not double");
+static_assert(!wkbhpp::point_traits<point_with_accessors>::xy_layout, "unknown layout");
+static_assert(wkbhpp::point_traits<lonlat>::xy_layout, "specialization");
+
+namespace {
+
+    const std::vector<coordinates> points{{3.2, 4.2}, {3.5, 4.7}, {3.6, 4.9}, {3.2, 4.2}};
+
+    std::string expected_linestring(wkbhpp::WKBWriter& writer) {
+        writer.linestring_start();
+        for (const auto& p : points) {
+            writer.linestring_add_location(p.x, p.y);
+        }
+        return writer.linestring_finish(points.size());
+    }
+
+    template <typename TContainer>
+    TContainer convert() {
+        TContainer result;
+        for (const auto& p : points) {
+            result.insert(result.end(), typename TContainer::value_type{p.x, p.y});
+        }
+        return result;
+    }
+
+} // anonymous namespace
+
+TEST_CASE("make_linestring from ranges of different point types") {
+    for (const auto otype : {wkbhpp::out_type::binary, wkbhpp::out_type::hex}) {
+        wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb, otype};
+        const std::string expected = expected_linestring(writer);
+
+        REQUIRE(writer.make_linestring(points) == expected);
+        REQUIRE(writer.make_linestring(convert<std::vector<coordinates_with_constructor>>()) == expected);
+        REQUIRE(writer.make_linestring(convert<std::vector<swapped_coordinates>>()) != expected);
+        REQUIRE(writer.make_linestring(convert<std::list<std::pair<double, double>>>()) == expected);
+        REQUIRE(writer.make_linestring(convert<std::vector<point_with_accessors>>()) == expected);
+        REQUIRE(writer.make_linestring(convert<std::vector<lonlat>>()) == expected);
+
+        const std::array<coordinates, 4> array{{points[0], points[1], points[2], points[3]}};
+        REQUIRE(writer.make_linestring(array) == expected);
+
+        std::string out{"x"};
+        writer.make_linestring(points, out);
+        REQUIRE(out == "x" + expected);
+    }
+}
+
+TEST_CASE("linestring_add_locations with iterators") {
+    wkbhpp::WKBWriter writer{4326};
+    const std::string expected = expected_linestring(writer);
+
+    writer.linestring_start();
+    writer.linestring_add_locations(points.data(), points.data() + 2);
+    writer.linestring_add_locations(points.begin() + 2, points.end());
+    REQUIRE(writer.linestring_finish(points.size()) == expected);
+
+    // single pass iterators
+    std::stringstream ss{"3.2 4.2 3.5 4.7 3.6 4.9 3.2 4.2"};
+    writer.linestring_start();
+    writer.linestring_add_locations(std::istream_iterator<coordinates>{ss}, std::istream_iterator<coordinates>{});
+    REQUIRE(writer.linestring_finish(points.size()) == expected);
+}
+
+TEST_CASE("make_polygon from a range of rings") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::wkb, wkbhpp::out_type::hex};
+
+    const std::vector<coordinates> inner{{3.3, 4.3}, {3.3, 4.4}, {3.4, 4.4}, {3.3, 4.3}};
+
+    writer.polygon_start();
+    writer.polygon_outer_ring_start();
+    for (const auto& p : points) {
+        writer.polygon_add_location(p.x, p.y);
+    }
+    writer.polygon_outer_ring_finish();
+    writer.polygon_inner_ring_start();
+    for (const auto& p : inner) {
+        writer.polygon_add_location(p.x, p.y);
+    }
+    writer.polygon_inner_ring_finish();
+    const std::string expected{writer.polygon_finish()};
+
+    const std::vector<std::vector<coordinates>> rings{points, inner};
+    REQUIRE(writer.make_polygon(rings) == expected);
+
+    const std::vector<std::list<std::pair<double, double>>> list_rings{
+        convert<std::list<std::pair<double, double>>>(),
+        {{3.3, 4.3}, {3.3, 4.4}, {3.4, 4.4}, {3.3, 4.3}}
+    };
+    REQUIRE(writer.make_polygon(list_rings) == expected);
+}
@@ -0,0 +1,132 @@
+#include "catch.hpp"
+
+#include <wkbhpp/simplify.hpp>
+#include <wkbhpp/validate.hpp>
+#include <wkbhpp/wkbview.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::vector<double> xy_of(const wkbhpp::point_sequence& points) {
+        std::vector<double> result;
+        for (const auto& p : points) {
+            result.push_back(p.x());
+            result.push_back(p.y());
+        }
+        return result;
+    }
+
+    // square with small bumps on each side
+    std::vector<double> bumpy_square() {
+        return {0.0, 0.0,   1.0, 0.01,  2.0, 0.0,  3.0, -0.01, 4.0, 0.0,
+                4.0, 2.0,   4.0, 4.0,   2.0, 4.01, 0.0, 4.0,   0.0, 2.0,
+                0.0, 0.0};
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Douglas-Peucker simplification of a linestring") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Simplifier<wkbhpp::WKBWriter> simplifier{writer, 0.1};
+
+    simplifier.linestring_start();
+    for (const double x : {0.0, 1.0, 2.0, 3.0, 4.0}) {
+        simplifier.linestring_add_location(x, x == 2.0 ? 0.05 : 0.0);
+    }
+    simplifier.linestring_add_location(4.0, 3.0);
+    const std::string wkb = simplifier.linestring_finish();
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(xy_of(view.points()) == (std::vector<double>{0.0, 0.0, 4.0, 0.0, 4.0, 3.0}));
+
+    // a point beyond the tolerance is kept
+    simplifier.set_tolerance(0.03);
+    simplifier.linestring_start();
+    for (const double x : {0.0, 1.0, 2.0, 3.0, 4.0}) {
+        simplifier.linestring_add_location(x, x == 2.0 ? 0.05 : 0.0);
+    }
+    std::string out;
+    simplifier.linestring_finish(out);
+    REQUIRE(xy_of(wkbhpp::WKBView{out}.points()) == (std::vector<double>{0.0, 0.0, 2.0, 0.05, 4.0, 0.0}));
+}
+
+TEST_CASE("Simplified rings stay valid") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb};
+
+    for (const auto algorithm : {wkbhpp::simplify_algorithm::douglas_peucker, wkbhpp::simplify_algorithm::visvalingam}) {
+        wkbhpp::Simplifier<wkbhpp::WKBWriter> simplifier{writer, 0.5, algorithm};
+        const auto ring = bumpy_square();
+
+        simplifier.polygon_start();
+        simplifier.polygon_outer_ring_start();
+        simplifier.polygon_add_locations(ring.data(), ring.size() / 2);
+        simplifier.polygon_outer_ring_finish();
+        const std::string wkb = simplifier.polygon_finish();
+        REQUIRE(wkbhpp::validate(wkb.data(), wkb.size()) == wkbhpp::wkb_status::ok);
+        const auto points = *wkbhpp::WKBView{wkb}.rings().begin();
+        REQUIRE(xy_of(points) == (std::vector<double>{0.0, 0.0, 4.0, 0.0, 4.0, 4.0, 0.0, 4.0, 0.0, 0.0}));
+
+        // even with a huge tolerance a ring keeps 4 points and stays closed
+        simplifier.set_tolerance(100.0);
+        simplifier.polygon_start();
+        simplifier.polygon_outer_ring_start();
+        simplifier.polygon_add_locations(ring.data(), ring.size() / 2);
+        simplifier.polygon_outer_ring_finish();
+        const std::string tiny = simplifier.polygon_finish();
+        const auto tiny_points = *wkbhpp::WKBView{tiny}.rings().begin();
+        REQUIRE(tiny_points.size() >= 4);
+        REQUIRE(tiny_points[0].x() == tiny_points[tiny_points.size() - 1].x());
+        REQUIRE(tiny_points[0].y() == tiny_points[tiny_points.size() - 1].y());
+    }
+}
+
+TEST_CASE("Visvalingam simplification removes small triangles first") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Simplifier<wkbhpp::WKBWriter> simplifier{writer, 1.0, wkbhpp::simplify_algorithm::visvalingam};
+    simplifier.linestring_start();
+    simplifier.linestring_add_location(0.0, 0.0);
+    simplifier.linestring_add_location(1.0, 0.1); // triangle area 0.1
+    simplifier.linestring_add_location(2.0, 0.0);
+    simplifier.linestring_add_location(3.0, 2.0); // triangle area 2
+    simplifier.linestring_add_location(4.0, 0.0);
+    const std::string wkb = simplifier.linestring_finish();
+    REQUIRE(xy_of(wkbhpp::WKBView{wkb}.points()) == (std::vector<double>{0.0, 0.0, 2.0, 0.0, 3.0, 2.0, 4.0, 0.0}));
+}
+
+TEST_CASE("Simplification of multi geometries counts the surviving points") {
+    using writer_type = wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary,
+                                               wkbhpp::native_byte_order, wkbhpp::dimensions::xyz>;
+    writer_type writer{4326};
+    wkbhpp::Simplifier<writer_type> simplifier{writer, 0.1};
+
+    simplifier.multipolygon_start();
+    for (int p = 0; p < 2; ++p) {
+        simplifier.multipolygon_polygon_start();
+        simplifier.multipolygon_outer_ring_start();
+        const auto ring = bumpy_square();
+        for (std::size_t i = 0; i < ring.size(); i += 2) {
+            simplifier.multipolygon_add_location(ring[i] + 10.0 * p, ring[i + 1], static_cast<double>(i));
+        }
+        simplifier.multipolygon_outer_ring_finish();
+        simplifier.multipolygon_polygon_finish();
+    }
+    const std::string wkb = simplifier.multipolygon_finish();
+    REQUIRE(wkbhpp::validate(wkb.data(), wkb.size()) == wkbhpp::wkb_status::ok);
+
+    std::size_t polygons = 0;
+    for (const auto& polygon : wkbhpp::WKBView{wkb}.geometries()) {
+        const auto ring = *polygon.rings().begin();
+        REQUIRE(ring.size() == 5);
+        REQUIRE(ring[1].x() == 4.0 + 10.0 * polygons);
+        REQUIRE(ring[1].z() == 8.0);
+        ++polygons;
+    }
+    REQUIRE(polygons == 2);
+
+    simplifier.multilinestring_start();
+    simplifier.multilinestring_linestring_start();
+    REQUIRE_THROWS_AS(simplifier.multilinestring_add_location(1.0, 2.0), const wkbhpp::wkb_error&);
+}
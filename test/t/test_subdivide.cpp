@@ -0,0 +1,235 @@
+#include "catch.hpp"
+
+#include <wkbhpp/subdivide.hpp>
+#include <wkbhpp/validate.hpp>
+#include <wkbhpp/wkbview.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    // counterclockwise ring of n points around (cx, cy), closed
+    std::vector<double> circle(double cx, double cy, double r, std::size_t n) {
+        std::vector<double> ring;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double a = 2 * 3.14159265358979323846 * i / n;
+            ring.push_back(cx + r * std::cos(a));
+            ring.push_back(cy + r * std::sin(a));
+        }
+        ring.push_back(ring[0]);
+        ring.push_back(ring[1]);
+        return ring;
+    }
+
+    double ring_area(const wkbhpp::point_sequence& points) {
+        double sum = 0.0;
+        for (std::size_t i = 1; i < points.size(); ++i) {
+            sum += points[i - 1].x() * points[i].y() - points[i].x() * points[i - 1].y();
+        }
+        return sum / 2;
+    }
+
+    // closed ring along the border of the square, n points on each side
+    std::vector<double> square(double min, double max, std::size_t n, bool clockwise = false) {
+        std::vector<double> ring;
+        const double step = (max - min) / n;
+        const double corners[4][2] = {{min, min}, {max, min}, {max, max}, {min, max}};
+        for (std::size_t side = 0; side < 4; ++side) {
+            const double* from = corners[side];
+            const double* to = corners[(side + 1) % 4];
+            for (std::size_t i = 0; i < n; ++i) {
+                ring.push_back(from[0] + (to[0] - from[0]) / (max - min) * step * i);
+                ring.push_back(from[1] + (to[1] - from[1]) / (max - min) * step * i);
+            }
+        }
+        ring.push_back(min);
+        ring.push_back(min);
+        if (clockwise) {
+            std::vector<double> reversed;
+            for (std::size_t i = ring.size(); i > 0; i -= 2) {
+                reversed.push_back(ring[i - 2]);
+                reversed.push_back(ring[i - 1]);
+            }
+            ring.swap(reversed);
+        }
+        return ring;
+    }
+
+    void add_polygon(wkbhpp::Subdivider<wkbhpp::WKBWriter>& subdivider, const std::vector<double>& outer,
+                     const std::vector<double>& inner = {}) {
+        subdivider.multipolygon_polygon_start();
+        subdivider.multipolygon_outer_ring_start();
+        subdivider.multipolygon_add_locations(outer.data(), outer.size() / 2);
+        subdivider.multipolygon_outer_ring_finish();
+        if (!inner.empty()) {
+            subdivider.multipolygon_inner_ring_start();
+            subdivider.multipolygon_add_locations(inner.data(), inner.size() / 2);
+            subdivider.multipolygon_inner_ring_finish();
+        }
+        subdivider.multipolygon_polygon_finish();
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Polygons below the limit are written as one MultiPolygon") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb};
+    wkbhpp::Subdivider<wkbhpp::WKBWriter> subdivider{writer, 100};
+
+    const auto a = circle(0.0, 0.0, 1.0, 20);
+    const auto b = circle(5.0, 0.0, 1.0, 20);
+    subdivider.multipolygon_start();
+    add_polygon(subdivider, a);
+    add_polygon(subdivider, b);
+    const auto result = subdivider.multipolygon_finish();
+    REQUIRE(result.size() == 1);
+
+    writer.multipolygon_start();
+    for (const auto* ring : {&a, &b}) {
+        writer.multipolygon_polygon_start();
+        writer.multipolygon_outer_ring_start();
+        writer.multipolygon_add_locations(ring->data(), ring->size() / 2);
+        writer.multipolygon_outer_ring_finish();
+        writer.multipolygon_polygon_finish();
+    }
+    REQUIRE(result.front() == writer.multipolygon_finish());
+}
+
+TEST_CASE("Large polygons are split into pieces below the limit") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb};
+    wkbhpp::Subdivider<wkbhpp::WKBWriter> subdivider{writer, 50};
+
+    const auto small = circle(10.0, 0.0, 1.0, 20);
+    const auto large = circle(0.0, 0.0, 4.0, 1000);
+    auto hole = circle(0.5, 0.5, 1.0, 30);
+    std::vector<double> reversed;
+    for (std::size_t i = hole.size(); i > 0; i -= 2) {
+        reversed.push_back(hole[i - 2]);
+        reversed.push_back(hole[i - 1]);
+    }
+
+    subdivider.multipolygon_start();
+    add_polygon(subdivider, large, reversed);
+    add_polygon(subdivider, small);
+    std::string batch;
+    std::vector<std::size_t> offsets;
+    const std::size_t count = subdivider.multipolygon_finish(batch, offsets);
+    REQUIRE(count + 1 == offsets.size());
+    REQUIRE(offsets.back() == batch.size());
+    REQUIRE(count > 4);
+    std::vector<std::string> result;
+    for (std::size_t i = 1; i < offsets.size(); ++i) {
+        result.emplace_back(batch, offsets[i - 1], offsets[i] - offsets[i - 1]);
+    }
+    REQUIRE(wkbhpp::validate(batch.data(), offsets.data(), count).empty());
+
+    // first the small polygon
+    const wkbhpp::WKBView first{result.front()};
+    REQUIRE(first.geometries().size() == 1);
+    REQUIRE((*first.geometries().begin()->rings().begin()).size() == 21);
+
+    double area = 0.0;
+    for (std::size_t i = 1; i < result.size(); ++i) {
+        REQUIRE(wkbhpp::validate(result[i].data(), result[i].size()) == wkbhpp::wkb_status::ok);
+        const wkbhpp::WKBView view{result[i]};
+        REQUIRE(view.type() == wkbhpp::geometry_type::multipolygon);
+        REQUIRE(view.srid() == 4326);
+        std::size_t points = 0;
+        for (const auto& polygon : view.geometries()) {
+            for (const auto& ring : polygon.rings()) {
+                points += ring.size();
+                REQUIRE(ring[0].x() == ring[ring.size() - 1].x());
+                REQUIRE(ring[0].y() == ring[ring.size() - 1].y());
+                area += ring_area(ring);
+            }
+        }
+        REQUIRE(points <= 50);
+    }
+
+    // the pieces cover the polygon exactly
+    const double expected = 1000 * 16.0 * std::sin(2 * 3.14159265358979323846 / 1000) / 2 -
+                            30 * std::sin(2 * 3.14159265358979323846 / 30) / 2;
+    REQUIRE(area == Approx(expected));
+
+    // the buffers are reused for the next MultiPolygon, results are
+    // appended
+    subdivider.multipolygon_start();
+    add_polygon(subdivider, large);
+    REQUIRE(subdivider.multipolygon_finish(batch, offsets) > 4);
+    REQUIRE(offsets[count] == result.back().size() + offsets[count - 1]);
+    REQUIRE(offsets.back() == batch.size());
+
+    // a batch cleared for the next MultiPolygon keeps its capacity
+    const std::size_t capacity = batch.capacity();
+    batch.clear();
+    offsets.clear();
+    subdivider.multipolygon_start();
+    add_polygon(subdivider, large);
+    subdivider.multipolygon_finish(batch, offsets);
+    REQUIRE(batch.capacity() == capacity);
+}
+
+TEST_CASE("The limit of a Subdivider must allow a closed ring") {
+    wkbhpp::WKBWriter writer{4326};
+    REQUIRE_THROWS_AS((wkbhpp::Subdivider<wkbhpp::WKBWriter>{writer, 4}), const wkbhpp::wkb_error&);
+}
+
+TEST_CASE("Pieces inside a hole are dropped") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Subdivider<wkbhpp::WKBWriter> subdivider{writer, 9};
+
+    subdivider.multipolygon_start();
+    add_polygon(subdivider, square(0.0, 10.0, 1), square(4.0, 6.0, 1, true));
+    const auto result = subdivider.multipolygon_finish();
+    REQUIRE_FALSE(result.empty());
+
+    double area = 0.0;
+    for (const auto& piece : result) {
+        REQUIRE(wkbhpp::validate(piece.data(), piece.size()) == wkbhpp::wkb_status::ok);
+        for (const auto& polygon : wkbhpp::WKBView{piece}.geometries()) {
+            for (const auto& ring : polygon.rings()) {
+                area += ring_area(ring);
+            }
+        }
+    }
+    REQUIRE(area == Approx(96.0));
+}
+
+TEST_CASE("Pieces are valid polygons") {
+    wkbhpp::WKBWriter writer{4326};
+    wkbhpp::Subdivider<wkbhpp::WKBWriter> subdivider{writer, 20};
+
+    subdivider.multipolygon_start();
+    add_polygon(subdivider, square(0.0, 10.0, 10), square(1.0, 9.0, 2, true));
+    const auto result = subdivider.multipolygon_finish();
+    REQUIRE(result.size() > 1);
+
+    double area = 0.0;
+    for (const auto& piece : result) {
+        REQUIRE(wkbhpp::validate(piece.data(), piece.size()) == wkbhpp::wkb_status::ok);
+
+        // no edge is used twice, by the same or another ring
+        std::set<std::pair<std::pair<double, double>, std::pair<double, double>>> edges;
+        for (const auto& polygon : wkbhpp::WKBView{piece}.geometries()) {
+            for (const auto& ring : polygon.rings()) {
+                REQUIRE(ring.size() >= 4);
+                for (std::size_t i = 1; i < ring.size(); ++i) {
+                    auto a = std::make_pair(ring[i - 1].x(), ring[i - 1].y());
+                    auto b = std::make_pair(ring[i].x(), ring[i].y());
+                    REQUIRE(a != b);
+                    if (b < a) {
+                        std::swap(a, b);
+                    }
+                    REQUIRE(edges.insert(std::make_pair(a, b)).second);
+                }
+                area += ring_area(ring);
+            }
+        }
+    }
+    REQUIRE(area == Approx(100.0 - 64.0));
+}
@@ -0,0 +1,272 @@
+#include "catch.hpp"
+
+#include <wkbhpp/transform.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::vector<wkbhpp::detail::simd_level> supported_levels() {
+        std::vector<wkbhpp::detail::simd_level> levels;
+        for (const auto level : {wkbhpp::detail::simd_level::sse2,
+                                 wkbhpp::detail::simd_level::ssse3,
+                                 wkbhpp::detail::simd_level::avx2}) {
+            if (level <= wkbhpp::detail::cpu_simd_level()) {
+                levels.push_back(level);
+            }
+        }
+        return levels;
+    }
+
+    template <typename TWriter>
+    std::string make_multipolygon(TWriter& writer) {
+        writer.multipolygon_start();
+        for (int p = 0; p < 2; ++p) {
+            writer.multipolygon_polygon_start();
+            writer.multipolygon_outer_ring_start();
+            writer.multipolygon_add_location(0.0 + p, 0.0);
+            writer.multipolygon_add_location(4.0 + p, 0.0);
+            writer.multipolygon_add_location(4.0 + p, 4.0);
+            writer.multipolygon_add_location(0.0 + p, 0.0);
+            writer.multipolygon_outer_ring_finish();
+            writer.multipolygon_inner_ring_start();
+            writer.multipolygon_add_location(1.0 + p, 1.0);
+            writer.multipolygon_add_location(2.0 + p, 1.0);
+            writer.multipolygon_add_location(2.0 + p, 2.0);
+            writer.multipolygon_add_location(1.0 + p, 1.0);
+            writer.multipolygon_inner_ring_finish();
+            writer.multipolygon_polygon_finish();
+        }
+        return writer.multipolygon_finish();
+    }
+
+} // anonymous namespace
+
+TEST_CASE("SIMD byte swapping is identical to scalar byte swapping") {
+    std::mt19937 gen{17};
+    std::uniform_int_distribution<int> byte{0, 255};
+    std::string data(8 * 40 + 3, '\0');
+    for (auto& c : data) {
+        c = static_cast<char>(byte(gen));
+    }
+
+    for (const auto level : supported_levels()) {
+        const auto swap = wkbhpp::detail::byte_swapper(level);
+        for (std::size_t n = 0; n < 40; ++n) {
+            for (std::size_t start = 0; start < 3; ++start) {
+                std::string expected(8 * n, '\0');
+                wkbhpp::detail::byte_swap_doubles_scalar(&expected[0], &data[start], n);
+                std::string result(8 * n, '\0');
+                swap(&result[0], &data[start], n);
+                REQUIRE(result == expected);
+
+                // in place
+                std::string inplace = data.substr(start, 8 * n);
+                swap(&inplace[0], &inplace[0], n);
+                REQUIRE(inplace == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("WKBWriter with runtime byte order") {
+    wkbhpp::WKBWriter xdr{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex, wkbhpp::byte_order::xdr};
+    REQUIRE(xdr.make_point(1.0, 2.0) == "0020000001000010E63FF00000000000004000000000000000");
+
+    wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary, wkbhpp::byte_order::xdr> basic{4326};
+    wkbhpp::WKBWriter dynamic{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary, wkbhpp::byte_order::xdr};
+    REQUIRE(make_multipolygon(dynamic) == make_multipolygon(basic));
+}
+
+TEST_CASE("Byte order conversion in place") {
+    for (const auto wtype : {wkbhpp::wkb_type::wkb, wkbhpp::wkb_type::ewkb}) {
+        wkbhpp::WKBWriter ndr_writer{3857, wtype, wkbhpp::out_type::binary, wkbhpp::byte_order::ndr};
+        wkbhpp::WKBWriter xdr_writer{3857, wtype, wkbhpp::out_type::binary, wkbhpp::byte_order::xdr};
+        const std::string ndr = make_multipolygon(ndr_writer);
+        const std::string xdr = make_multipolygon(xdr_writer);
+        REQUIRE(ndr != xdr);
+
+        std::string wkb{xdr};
+        REQUIRE(wkbhpp::set_byte_order(&wkb[0], wkb.size(), wkbhpp::byte_order::ndr) == wkb.size());
+        REQUIRE(wkb == ndr);
+
+        wkbhpp::set_byte_order(wkb, wkbhpp::byte_order::ndr);
+        REQUIRE(wkb == ndr);
+
+        wkbhpp::set_byte_order(wkb, wkbhpp::byte_order::xdr);
+        REQUIRE(wkb == xdr);
+
+        // a long linestring uses the SIMD code
+        ndr_writer.linestring_start();
+        xdr_writer.linestring_start();
+        for (int i = 0; i < 100; ++i) {
+            ndr_writer.linestring_add_location(i, -i);
+            xdr_writer.linestring_add_location(i, -i);
+        }
+        std::string linestring = xdr_writer.linestring_finish(100);
+        wkbhpp::set_byte_order(linestring, wkbhpp::byte_order::ndr);
+        REQUIRE(linestring == ndr_writer.linestring_finish(100));
+    }
+}
+
+TEST_CASE("Byte order conversion of mixed byte orders") {
+    wkbhpp::WKBWriter ndr_writer{0, wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary, wkbhpp::byte_order::ndr};
+    wkbhpp::WKBWriter xdr_writer{0, wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary, wkbhpp::byte_order::xdr};
+
+    // GeometryCollection (NDR) of an XDR and an NDR point
+    const std::string collection{"\x01\x07\x00\x00\x00\x02\x00\x00\x00", 9};
+    std::string wkb = collection + xdr_writer.make_point(1.0, 2.0) + ndr_writer.make_point(3.0, 4.0);
+    wkbhpp::set_byte_order(wkb, wkbhpp::byte_order::ndr);
+
+    const std::string expected = collection + ndr_writer.make_point(1.0, 2.0) + ndr_writer.make_point(3.0, 4.0);
+    REQUIRE(wkb == expected);
+}
+
+TEST_CASE("Byte order conversion leaves invalid input untouched") {
+    wkbhpp::WKBWriter writer{0};
+    std::string wkb = make_multipolygon(writer);
+    wkb.resize(wkb.size() - 1);
+    const std::string copy{wkb};
+    REQUIRE_THROWS_AS(wkbhpp::set_byte_order(wkb, wkbhpp::byte_order::xdr), const wkbhpp::wkb_error&);
+    REQUIRE(wkb == copy);
+}
+
+TEST_CASE("Conversion between WKB and EWKB") {
+    for (const auto order : {wkbhpp::byte_order::ndr, wkbhpp::byte_order::xdr}) {
+        wkbhpp::WKBWriter wkb_writer{4326, wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary, order};
+        wkbhpp::WKBWriter ewkb_writer{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary, order};
+        wkbhpp::WKBWriter ewkb_3857_writer{3857, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary, order};
+
+        const std::string wkb = make_multipolygon(wkb_writer);
+        const std::string ewkb = make_multipolygon(ewkb_writer);
+
+        REQUIRE(wkbhpp::convert_to_ewkb(wkb, 4326) == ewkb);
+        REQUIRE(wkbhpp::convert_to_wkb(ewkb) == wkb);
+        REQUIRE(wkbhpp::convert_to_wkb(wkb) == wkb);
+        REQUIRE(wkbhpp::convert_to_ewkb(ewkb, 3857) == make_multipolygon(ewkb_3857_writer));
+
+        std::string out{"x"};
+        REQUIRE(wkbhpp::append_as(out, ewkb.data(), ewkb.size(), wkbhpp::wkb_type::wkb) == ewkb.size());
+        REQUIRE(out == "x" + wkb);
+
+        REQUIRE(wkbhpp::convert_to_ewkb(wkb_writer.make_point(1.0, 2.0), 4326) == ewkb_writer.make_point(1.0, 2.0));
+    }
+}
+
+TEST_CASE("Conversion between WKB and EWKB with Z and M") {
+    for (const auto dims : {wkbhpp::dimensions::xyz, wkbhpp::dimensions::xym, wkbhpp::dimensions::xyzm}) {
+        for (const auto order : {wkbhpp::byte_order::ndr, wkbhpp::byte_order::xdr}) {
+            wkbhpp::WKBWriter wkb_writer{4326, wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary, order, dims};
+            wkbhpp::WKBWriter ewkb_writer{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary, order, dims};
+            const std::size_t stride = wkbhpp::stride(dims);
+            const std::vector<double> coords{0.0, 0.0, 1.0, 2.0, 1.0, 0.0, 3.0, 4.0,
+                                             1.0, 1.0, 5.0, 6.0, 0.0, 0.0, 1.0, 2.0};
+            std::vector<double> points;
+            for (std::size_t i = 0; i < 4; ++i) {
+                points.insert(points.end(), coords.begin() + i * 4, coords.begin() + i * 4 + stride);
+            }
+
+            for (auto* writer : {&wkb_writer, &ewkb_writer}) {
+                writer->geometrycollection_start();
+                writer->multipoint_start();
+                writer->multipoint_add_locations(points.data(), 4);
+                writer->multipoint_finish();
+                writer->multipolygon_start();
+                writer->multipolygon_polygon_start();
+                writer->multipolygon_outer_ring_start();
+                writer->multipolygon_add_locations(points.data(), 4);
+                writer->multipolygon_outer_ring_finish();
+                writer->multipolygon_polygon_finish();
+                writer->multipolygon_finish();
+            }
+            const std::string wkb = wkb_writer.geometrycollection_finish();
+            const std::string ewkb = ewkb_writer.geometrycollection_finish();
+
+            REQUIRE(wkbhpp::convert_to_ewkb(wkb, 4326) == ewkb);
+            REQUIRE(wkbhpp::convert_to_wkb(ewkb) == wkb);
+            REQUIRE(wkbhpp::convert_to_wkb(wkb) == wkb);
+            REQUIRE(wkbhpp::convert_to_ewkb(ewkb, 4326) == ewkb);
+
+            const std::string wkb_point = stride == 3 ? wkb_writer.make_point(1.0, 2.0, 3.0)
+                                                      : wkb_writer.make_point(1.0, 2.0, 3.0, 4.0);
+            const std::string ewkb_point = stride == 3 ? ewkb_writer.make_point(1.0, 2.0, 3.0)
+                                                       : ewkb_writer.make_point(1.0, 2.0, 3.0, 4.0);
+            REQUIRE(wkbhpp::convert_to_ewkb(wkb_point, 4326) == ewkb_point);
+            REQUIRE(wkbhpp::convert_to_wkb(ewkb_point) == wkb_point);
+        }
+    }
+}
+
+TEST_CASE("SRID rewrite in place") {
+    wkbhpp::WKBWriter writer_4326{4326, wkbhpp::wkb_type::ewkb};
+    wkbhpp::WKBWriter writer_3857{3857, wkbhpp::wkb_type::ewkb};
+
+    std::string ewkb = make_multipolygon(writer_4326);
+    wkbhpp::set_srid(ewkb, 3857);
+    REQUIRE(ewkb == make_multipolygon(writer_3857));
+
+    wkbhpp::WKBWriter wkb_writer{4326};
+    std::string wkb = wkb_writer.make_point(1.0, 2.0);
+    REQUIRE_THROWS_AS(wkbhpp::set_srid(wkb, 3857), const wkbhpp::wkb_error&);
+}
+
+TEST_CASE("Conversion of columns") {
+    wkbhpp::WKBWriter wkb_writer{4326};
+    wkbhpp::WKBWriter ewkb_writer{4326, wkbhpp::wkb_type::ewkb};
+    wkbhpp::WKBWriter ewkb_3857_writer{3857, wkbhpp::wkb_type::ewkb};
+
+    std::string data;
+    std::vector<int64_t> offsets{0};
+    std::string expected;
+    for (int i = 0; i < 3; ++i) {
+        data += wkb_writer.make_point(i, i);
+        offsets.push_back(static_cast<int64_t>(data.size()));
+        expected += ewkb_writer.make_point(i, i);
+        data += make_multipolygon(wkb_writer);
+        offsets.push_back(static_cast<int64_t>(data.size()));
+        expected += make_multipolygon(ewkb_writer);
+    }
+
+    std::string out;
+    std::vector<int64_t> out_offsets;
+    wkbhpp::append_as(out, out_offsets, data.data(), offsets.data(), offsets.size() - 1, wkbhpp::wkb_type::ewkb, 4326);
+    REQUIRE(out == expected);
+    REQUIRE(out_offsets.size() == offsets.size());
+    REQUIRE(out_offsets[1] == static_cast<int64_t>(ewkb_writer.make_point(0, 0).size()));
+    REQUIRE(out_offsets.back() == static_cast<int64_t>(out.size()));
+
+    wkbhpp::set_srid(&out[0], out_offsets.data(), out_offsets.size() - 1, 3857);
+    REQUIRE(out.substr(0, static_cast<std::size_t>(out_offsets[2])) ==
+            ewkb_3857_writer.make_point(0, 0) + make_multipolygon(ewkb_3857_writer));
+
+    std::string back;
+    std::vector<int64_t> back_offsets;
+    wkbhpp::append_as(back, back_offsets, out.data(), out_offsets.data(), out_offsets.size() - 1, wkbhpp::wkb_type::wkb);
+    REQUIRE(back == data);
+    REQUIRE(back_offsets == offsets);
+
+    // a second column is appended behind the first one
+    wkbhpp::append_as(back, back_offsets, out.data(), out_offsets.data(), out_offsets.size() - 1, wkbhpp::wkb_type::wkb);
+    REQUIRE(back == data + data);
+    REQUIRE(back_offsets.size() == 2 * offsets.size() - 1);
+    REQUIRE(back_offsets[offsets.size()] == offsets[1] + static_cast<int64_t>(data.size()));
+    REQUIRE(back_offsets.back() == static_cast<int64_t>(back.size()));
+
+    // an output which is not empty gets its size as first offset
+    std::string prefixed{"abc"};
+    std::vector<int64_t> prefixed_offsets;
+    wkbhpp::append_as(prefixed, prefixed_offsets, data.data(), offsets.data(), 1, wkbhpp::wkb_type::wkb);
+    REQUIRE(prefixed_offsets == (std::vector<int64_t>{3, offsets[1] + 3}));
+
+    const std::string out_before = out;
+    const std::vector<int64_t> out_offsets_before = out_offsets;
+    offsets[1] += 1;
+    REQUIRE_THROWS_AS(wkbhpp::append_as(out, out_offsets, data.data(), offsets.data(), 2, wkbhpp::wkb_type::ewkb, 4326),
+                      const wkbhpp::wkb_error&);
+    REQUIRE(out == out_before);
+    REQUIRE(out_offsets == out_offsets_before);
+}
@@ -0,0 +1,130 @@
+#include "catch.hpp"
+
+#include <wkbhpp/validate.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::string ndr_header(uint32_t type) {
+        std::string str(1, '\x01');
+        wkbhpp::str_push(str, type);
+        return str;
+    }
+
+    wkbhpp::wkb_status validate(const std::string& wkb) {
+        return wkbhpp::validate(wkb.data(), wkb.size());
+    }
+
+    std::string make_polygon(wkbhpp::WKBWriter& writer) {
+        writer.polygon_start();
+        writer.polygon_outer_ring_start();
+        writer.polygon_add_location(0.0, 0.0);
+        writer.polygon_add_location(4.0, 0.0);
+        writer.polygon_add_location(4.0, 4.0);
+        writer.polygon_add_location(0.0, 0.0);
+        writer.polygon_outer_ring_finish();
+        return writer.polygon_finish();
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Output of WKBWriter is valid") {
+    for (const auto wtype : {wkbhpp::wkb_type::wkb, wkbhpp::wkb_type::ewkb}) {
+        wkbhpp::WKBWriter writer{4326, wtype};
+        REQUIRE(validate(writer.make_point(1.0, 2.0)) == wkbhpp::wkb_status::ok);
+        REQUIRE(validate(make_polygon(writer)) == wkbhpp::wkb_status::ok);
+
+        writer.linestring_start();
+        const std::string empty = writer.linestring_finish(0);
+        REQUIRE(validate(empty) == wkbhpp::wkb_status::ok);
+    }
+
+    wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary, wkbhpp::byte_order::xdr> xdr_writer{4326};
+    REQUIRE(validate(xdr_writer.make_point(1.0, 2.0)) == wkbhpp::wkb_status::ok);
+}
+
+TEST_CASE("Structural errors are detected") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb};
+    const std::string polygon = make_polygon(writer);
+
+    SECTION("truncated") {
+        for (std::size_t size = 0; size < polygon.size(); ++size) {
+            REQUIRE(wkbhpp::validate(polygon.data(), size) == wkbhpp::wkb_status::truncated);
+        }
+    }
+
+    SECTION("trailing bytes") {
+        REQUIRE(validate(polygon + '\0') == wkbhpp::wkb_status::trailing_bytes);
+    }
+
+    SECTION("byte order marker") {
+        std::string wkb{polygon};
+        wkb[0] = 'x';
+        REQUIRE(validate(wkb) == wkbhpp::wkb_status::invalid_byte_order);
+    }
+
+    SECTION("type") {
+        REQUIRE(validate(ndr_header(0)) == wkbhpp::wkb_status::unknown_type);
+        REQUIRE(validate(ndr_header(8)) == wkbhpp::wkb_status::unknown_type);
+        REQUIRE(validate(ndr_header(4002)) == wkbhpp::wkb_status::unknown_type);
+    }
+
+    SECTION("SRID flag without SRID") {
+        REQUIRE(validate(ndr_header(0x20000001)) == wkbhpp::wkb_status::truncated);
+    }
+
+    SECTION("huge counts") {
+        std::string rings = ndr_header(3);
+        wkbhpp::str_push(rings, static_cast<uint32_t>(0xffffffff));
+        REQUIRE(validate(rings) == wkbhpp::wkb_status::truncated);
+
+        std::string points = ndr_header(0xc0000002); // LineString ZM
+        wkbhpp::str_push(points, static_cast<uint32_t>(0x10000000));
+        points.append(32, '\0');
+        REQUIRE(validate(points) == wkbhpp::wkb_status::truncated);
+    }
+
+    SECTION("member types") {
+        std::string wkb = ndr_header(6);
+        wkbhpp::str_push(wkb, static_cast<uint32_t>(1));
+        wkb += writer.make_point(1.0, 2.0);
+        REQUIRE(validate(wkb) == wkbhpp::wkb_status::invalid_member);
+    }
+
+    SECTION("nesting") {
+        std::string wkb;
+        for (std::size_t i = 0; i < wkbhpp::max_collection_depth; ++i) {
+            wkb += ndr_header(7);
+            wkbhpp::str_push(wkb, static_cast<uint32_t>(1));
+        }
+        REQUIRE(validate(wkb + make_polygon(writer)) == wkbhpp::wkb_status::ok);
+        wkb += ndr_header(7);
+        wkbhpp::str_push(wkb, static_cast<uint32_t>(0));
+        REQUIRE(validate(wkb) == wkbhpp::wkb_status::nested_too_deeply);
+    }
+}
+
+TEST_CASE("Validation of a column returns the invalid rows") {
+    wkbhpp::WKBWriter writer{4326};
+    std::string data;
+    std::vector<int32_t> offsets{0};
+
+    const auto add = [&](const std::string& wkb) {
+        data += wkb;
+        offsets.push_back(static_cast<int32_t>(data.size()));
+    };
+    add(writer.make_point(1.0, 2.0));
+    add(make_polygon(writer).substr(1));
+    add(make_polygon(writer));
+    add(std::string{});
+    add(writer.make_point(1.0, 2.0) + "x");
+
+    REQUIRE(wkbhpp::validate(data.data(), offsets.data(), offsets.size() - 1) == (std::vector<std::size_t>{1, 3, 4}));
+
+    offsets[2] = offsets[1] - 1;
+    REQUIRE(wkbhpp::validate(data.data(), offsets.data(), 2) == (std::vector<std::size_t>{1}));
+}
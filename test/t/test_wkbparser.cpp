@@ -0,0 +1,295 @@
+#include "catch.hpp"
+
+#include <wkbhpp/wkbparser.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::string ndr_header(uint32_t type) {
+        std::string str(1, '\x01');
+        wkbhpp::str_push(str, type);
+        return str;
+    }
+
+    // Records the calls for the types which WKBWriter had originally.
+    class recorder {
+
+        std::string m_log;
+
+    public:
+
+        const std::string& log() const noexcept {
+            return m_log;
+        }
+
+        void make_point(double x, double y) {
+            m_log += "point(" + std::to_string(int(x)) + "," + std::to_string(int(y)) + ") ";
+        }
+
+        void linestring_start() { add("ls_start"); }
+        void linestring_add_location(double /*x*/, double /*y*/) { add("ls_add"); }
+        void linestring_finish(std::size_t n) { m_log += "ls_finish(" + std::to_string(n) + ") "; }
+
+        void polygon_start() { add("p_start"); }
+        void polygon_outer_ring_start() { add("p_outer"); }
+        void polygon_outer_ring_finish() { add("p_outer_finish"); }
+        void polygon_inner_ring_start() { add("p_inner"); }
+        void polygon_inner_ring_finish() { add("p_inner_finish"); }
+        void polygon_add_location(double /*x*/, double /*y*/) { add("p_add"); }
+        void polygon_finish() { add("p_finish"); }
+
+        void multipolygon_start() { add("mp_start"); }
+        void multipolygon_polygon_start() { add("mp_polygon"); }
+        void multipolygon_polygon_finish() { add("mp_polygon_finish"); }
+        void multipolygon_outer_ring_start() { add("mp_outer"); }
+        void multipolygon_outer_ring_finish() { add("mp_outer_finish"); }
+        void multipolygon_inner_ring_start() { add("mp_inner"); }
+        void multipolygon_inner_ring_finish() { add("mp_inner_finish"); }
+        void multipolygon_add_location(double /*x*/, double /*y*/) { add("mp_add"); }
+        void multipolygon_finish() { add("mp_finish"); }
+
+    protected:
+
+        void add(const char* call) {
+            m_log += call;
+            m_log += ' ';
+        }
+
+    }; // class recorder
+
+    // Records the calls for all geometry types.
+    class collection_recorder : public recorder {
+
+    public:
+
+        void multipoint_start() { add("mpt_start"); }
+        void multipoint_add_location(double /*x*/, double /*y*/) { add("mpt_add"); }
+        void multipoint_finish() { add("mpt_finish"); }
+
+        void multilinestring_start() { add("mls_start"); }
+        void multilinestring_linestring_start() { add("mls_ls"); }
+        void multilinestring_add_location(double /*x*/, double /*y*/) { add("mls_add"); }
+        void multilinestring_linestring_finish() { add("mls_ls_finish"); }
+        void multilinestring_finish() { add("mls_finish"); }
+
+        void geometrycollection_start() { add("gc_start"); }
+        void geometrycollection_add_point(double /*x*/, double /*y*/) { add("gc_point"); }
+        void geometrycollection_finish() { add("gc_finish"); }
+
+    }; // class collection_recorder
+
+    std::string make_multipolygon(wkbhpp::WKBWriter& writer) {
+        writer.multipolygon_start();
+        writer.multipolygon_polygon_start();
+        writer.multipolygon_outer_ring_start();
+        writer.multipolygon_add_location(0.0, 0.0);
+        writer.multipolygon_add_location(4.0, 0.0);
+        writer.multipolygon_add_location(4.0, 4.0);
+        writer.multipolygon_add_location(0.0, 0.0);
+        writer.multipolygon_outer_ring_finish();
+        writer.multipolygon_inner_ring_start();
+        writer.multipolygon_add_location(1.0, 1.0);
+        writer.multipolygon_add_location(2.0, 1.0);
+        writer.multipolygon_add_location(2.0, 2.0);
+        writer.multipolygon_add_location(1.0, 1.0);
+        writer.multipolygon_inner_ring_finish();
+        writer.multipolygon_polygon_finish();
+        return writer.multipolygon_finish();
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Parser calls the handler methods of the geometry") {
+    wkbhpp::WKBWriter writer{0};
+    collection_recorder handler;
+
+    SECTION("point") {
+        const std::string wkb = writer.make_point(3.0, 4.0);
+        REQUIRE(wkbhpp::parse(wkb.data(), wkb.size(), handler) == wkb.size());
+        REQUIRE(handler.log() == "point(3,4) ");
+    }
+
+    SECTION("linestring") {
+        writer.linestring_start();
+        writer.linestring_add_location(1.0, 2.0);
+        writer.linestring_add_location(3.0, 4.0);
+        const std::string wkb = writer.linestring_finish(2);
+        wkbhpp::parse(wkb.data(), wkb.size(), handler);
+        REQUIRE(handler.log() == "ls_start ls_add ls_add ls_finish(2) ");
+    }
+
+    SECTION("multipolygon") {
+        const std::string wkb = make_multipolygon(writer);
+        wkbhpp::parse(wkb.data(), wkb.size(), handler);
+        REQUIRE(handler.log() == "mp_start mp_polygon mp_outer mp_add mp_add mp_add mp_add mp_outer_finish "
+                                 "mp_inner mp_add mp_add mp_add mp_add mp_inner_finish mp_polygon_finish mp_finish ");
+    }
+
+    SECTION("nested collections") {
+        const std::string point = writer.make_point(1.0, 2.0);
+
+        std::string multipoint = ndr_header(4);
+        wkbhpp::str_push(multipoint, static_cast<uint32_t>(2));
+        multipoint += point + point;
+
+        std::string empty = ndr_header(7);
+        wkbhpp::str_push(empty, static_cast<uint32_t>(0));
+
+        std::string inner = ndr_header(7);
+        wkbhpp::str_push(inner, static_cast<uint32_t>(2));
+        inner += empty + multipoint;
+
+        std::string wkb = ndr_header(7);
+        wkbhpp::str_push(wkb, static_cast<uint32_t>(2));
+        wkb += inner + point;
+
+        REQUIRE(wkbhpp::parse(wkb.data(), wkb.size(), handler) == wkb.size());
+        REQUIRE(handler.log() == "gc_start gc_start gc_start gc_finish mpt_start mpt_add mpt_add mpt_finish gc_finish gc_point gc_finish ");
+    }
+}
+
+TEST_CASE("Parser re-encodes geometries with a WKBWriter") {
+    wkbhpp::WKBWriter wkb_writer{4326};
+    const std::string wkb = make_multipolygon(wkb_writer);
+
+    wkbhpp::WKBWriter ewkb_writer{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex};
+    std::string out{"prefix"};
+    wkbhpp::parse(wkb.data(), wkb.size(), ewkb_writer, out);
+    REQUIRE(out == "prefix" + make_multipolygon(ewkb_writer));
+
+    // and back again
+    const std::string binary = wkbhpp::convert_from_hex(out.substr(6));
+    std::string result;
+    wkbhpp::parse(binary.data(), binary.size(), wkb_writer, result);
+    REQUIRE(result == wkb);
+}
+
+TEST_CASE("Parser re-encodes nested collections with a WKBWriter") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb};
+    writer.geometrycollection_start();
+    writer.multilinestring_start();
+    writer.multilinestring_linestring_start();
+    writer.multilinestring_add_location(1.0, 2.0);
+    writer.multilinestring_add_location(3.0, 4.0);
+    writer.multilinestring_linestring_finish();
+    writer.multilinestring_finish();
+    writer.geometrycollection_start();
+    writer.geometrycollection_add_point(5.0, 6.0);
+    writer.geometrycollection_finish();
+    writer.multipoint_start();
+    writer.multipoint_add_location(7.0, 8.0);
+    writer.multipoint_finish();
+    writer.geometrycollection_add_point(9.0, 10.0);
+    const std::string wkb = writer.geometrycollection_finish();
+
+    wkbhpp::WKBWriter hex_writer{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex};
+    std::string hex;
+    REQUIRE(wkbhpp::parse(wkb.data(), wkb.size(), hex_writer, hex) == wkb.size());
+    REQUIRE(hex == wkbhpp::convert_to_hex(wkb));
+}
+
+TEST_CASE("Parser rejects invalid input") {
+    wkbhpp::WKBWriter writer{0};
+    collection_recorder handler;
+
+    SECTION("truncated") {
+        const std::string wkb = make_multipolygon(writer);
+        for (std::size_t size = 0; size < wkb.size(); ++size) {
+            REQUIRE_THROWS_AS(wkbhpp::parse(wkb.data(), size, handler), const wkbhpp::wkb_error&);
+        }
+    }
+
+    SECTION("writer is usable after an error") {
+        const std::string wkb = make_multipolygon(writer);
+        wkbhpp::WKBWriter sink{4326, wkbhpp::wkb_type::ewkb};
+        std::string out;
+        REQUIRE_THROWS_AS(wkbhpp::parse(wkb.data(), wkb.size() - 10, sink, out), const wkbhpp::wkb_error&);
+
+        writer.linestring_start();
+        writer.linestring_add_location(1.0, 2.0);
+        writer.linestring_add_location(3.0, 4.0);
+        const std::string linestring = writer.linestring_finish(2);
+        wkbhpp::parse(linestring.data(), linestring.size(), sink, out);
+        REQUIRE(out.size() == 45);
+    }
+
+    SECTION("wrong member type") {
+        std::string wkb = ndr_header(5);
+        wkbhpp::str_push(wkb, static_cast<uint32_t>(1));
+        wkb += writer.make_point(1.0, 2.0);
+        REQUIRE_THROWS_AS(wkbhpp::parse(wkb.data(), wkb.size(), handler), const wkbhpp::wkb_error&);
+    }
+
+    SECTION("nested too deeply") {
+        std::string wkb;
+        for (std::size_t i = 0; i <= wkbhpp::max_collection_depth; ++i) {
+            wkb += ndr_header(7);
+            wkbhpp::str_push(wkb, static_cast<uint32_t>(1));
+        }
+        REQUIRE_THROWS_AS(wkbhpp::parse(wkb.data(), wkb.size(), handler), const wkbhpp::wkb_error&);
+    }
+
+    SECTION("type not supported by handler") {
+        std::string wkb = ndr_header(4);
+        wkbhpp::str_push(wkb, static_cast<uint32_t>(0));
+        recorder basic_handler;
+        REQUIRE_THROWS_AS(wkbhpp::parse(wkb.data(), wkb.size(), basic_handler), const wkbhpp::wkb_error&);
+    }
+}
+
+TEST_CASE("Parser reports Z and M values to writers with the same dimensions") {
+    for (const auto dims : {wkbhpp::dimensions::xyz, wkbhpp::dimensions::xym, wkbhpp::dimensions::xyzm}) {
+        for (const auto wtype : {wkbhpp::wkb_type::wkb, wkbhpp::wkb_type::ewkb}) {
+            wkbhpp::WKBWriter writer{4326, wtype, wkbhpp::out_type::binary, wkbhpp::native_byte_order, dims};
+            const std::size_t stride = wkbhpp::stride(dims);
+            const std::vector<double> coords{0.0, 0.0, 1.0, 2.0, 1.0, 0.0, 3.0, 4.0,
+                                             1.0, 1.0, 5.0, 6.0, 0.0, 0.0, 1.0, 2.0};
+            std::vector<double> points;
+            for (std::size_t i = 0; i < 4; ++i) {
+                points.insert(points.end(), coords.begin() + i * 4, coords.begin() + i * 4 + stride);
+            }
+
+            std::vector<std::string> geometries;
+            geometries.push_back(stride == 3 ? writer.make_point(1.0, 2.0, 3.0) : writer.make_point(1.0, 2.0, 3.0, 4.0));
+
+            writer.linestring_start();
+            writer.linestring_add_locations(points.data(), 4);
+            geometries.push_back(writer.linestring_finish(4));
+
+            writer.multipolygon_start();
+            writer.multipolygon_polygon_start();
+            writer.multipolygon_outer_ring_start();
+            writer.multipolygon_add_locations(points.data(), 4);
+            writer.multipolygon_outer_ring_finish();
+            writer.multipolygon_polygon_finish();
+            geometries.push_back(writer.multipolygon_finish());
+
+            writer.geometrycollection_start();
+            writer.multipoint_start();
+            writer.multipoint_add_locations(points.data(), 4);
+            writer.multipoint_finish();
+            writer.multilinestring_start();
+            writer.multilinestring_linestring_start();
+            writer.multilinestring_add_locations(points.data(), 4);
+            writer.multilinestring_linestring_finish();
+            writer.multilinestring_finish();
+            geometries.push_back(writer.geometrycollection_finish());
+
+            for (const auto& wkb : geometries) {
+                std::string out;
+                REQUIRE(wkbhpp::parse(wkb.data(), wkb.size(), writer, out) == wkb.size());
+                REQUIRE(out == wkb);
+            }
+
+            // a writer without Z and M does not silently drop them
+            wkbhpp::WKBWriter xy_writer{4326, wtype};
+            std::string out;
+            REQUIRE_THROWS_AS(wkbhpp::parse(geometries[1].data(), geometries[1].size(), xy_writer, out),
+                              const wkbhpp::wkb_error&);
+        }
+    }
+}
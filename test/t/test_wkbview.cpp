@@ -0,0 +1,201 @@
+#include "catch.hpp"
+
+#include <wkbhpp/wkbview.hpp>
+#include <wkbhpp/wkbwriter.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::string ndr_header(uint32_t type) {
+        std::string str(1, '\x01');
+        wkbhpp::str_push(str, type);
+        return str;
+    }
+
+    std::string make_multipolygon(wkbhpp::WKBWriter& writer) {
+        writer.multipolygon_start();
+        writer.multipolygon_polygon_start();
+        writer.multipolygon_outer_ring_start();
+        writer.multipolygon_add_location(0.0, 0.0);
+        writer.multipolygon_add_location(4.0, 0.0);
+        writer.multipolygon_add_location(4.0, 4.0);
+        writer.multipolygon_add_location(0.0, 0.0);
+        writer.multipolygon_outer_ring_finish();
+        writer.multipolygon_inner_ring_start();
+        writer.multipolygon_add_location(1.0, 1.0);
+        writer.multipolygon_add_location(2.0, 1.0);
+        writer.multipolygon_add_location(2.0, 2.0);
+        writer.multipolygon_add_location(1.0, 1.0);
+        writer.multipolygon_inner_ring_finish();
+        writer.multipolygon_polygon_finish();
+        writer.multipolygon_polygon_start();
+        writer.multipolygon_outer_ring_start();
+        writer.multipolygon_add_location(10.0, 10.0);
+        writer.multipolygon_add_location(11.0, 10.0);
+        writer.multipolygon_add_location(11.0, 11.0);
+        writer.multipolygon_add_location(10.0, 10.0);
+        writer.multipolygon_outer_ring_finish();
+        writer.multipolygon_polygon_finish();
+        return writer.multipolygon_finish();
+    }
+
+} // anonymous namespace
+
+TEST_CASE("WKBView of a point") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb};
+    const std::string wkb = writer.make_point(3.5, -1.25);
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(view.type() == wkbhpp::geometry_type::point);
+    REQUIRE(view.order() == wkbhpp::native_byte_order);
+    REQUIRE(view.has_srid());
+    REQUIRE(view.srid() == 4326);
+    REQUIRE_FALSE(view.has_z());
+    REQUIRE(view.size() == wkb.size());
+    REQUIRE(view.point().x() == 3.5);
+    REQUIRE(view.point().y() == -1.25);
+    REQUIRE(std::isnan(view.point().z()));
+    REQUIRE_THROWS_AS(view.points(), const wkbhpp::wkb_error&);
+}
+
+TEST_CASE("WKBView of a big endian linestring") {
+    wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary, wkbhpp::byte_order::xdr> writer{0};
+    writer.linestring_start();
+    writer.linestring_add_location(1.0, 2.0);
+    writer.linestring_add_location(3.0, 4.0);
+    writer.linestring_add_location(5.0, 6.0);
+    const std::string wkb = writer.linestring_finish(3);
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(view.type() == wkbhpp::geometry_type::linestring);
+    REQUIRE(view.order() == wkbhpp::byte_order::xdr);
+    REQUIRE_FALSE(view.has_srid());
+    REQUIRE(view.srid() == 0);
+
+    const auto points = view.points();
+    REQUIRE(points.size() == 3);
+    REQUIRE(points[2].x() == 5.0);
+    double sum = 0.0;
+    for (const auto point : points) {
+        sum += point.x() + point.y();
+    }
+    REQUIRE(sum == 21.0);
+}
+
+TEST_CASE("Points of a WKBView can be written again") {
+    wkbhpp::WKBWriter writer{0};
+    writer.linestring_start();
+    writer.linestring_add_location(1.0, 2.0);
+    writer.linestring_add_location(3.0, 4.0);
+    const std::string wkb = writer.linestring_finish(2);
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(writer.make_linestring(view.points()) == wkb);
+}
+
+TEST_CASE("WKBView of a multipolygon") {
+    wkbhpp::WKBWriter writer{3857, wkbhpp::wkb_type::ewkb};
+    const std::string wkb = make_multipolygon(writer);
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(view.type() == wkbhpp::geometry_type::multipolygon);
+    REQUIRE(view.size() == wkb.size());
+
+    const auto polygons = view.geometries();
+    REQUIRE(polygons.size() == 2);
+    std::vector<std::size_t> ring_sizes;
+    for (const auto& polygon : polygons) {
+        REQUIRE(polygon.type() == wkbhpp::geometry_type::polygon);
+        REQUIRE(polygon.srid() == 3857);
+        for (const auto ring : polygon.rings()) {
+            ring_sizes.push_back(ring.size());
+        }
+    }
+    REQUIRE(ring_sizes == (std::vector<std::size_t>{4, 4, 4}));
+
+    auto it = polygons.begin();
+    ++it;
+    REQUIRE((*it->rings().begin())[1].x() == 11.0);
+    ++it;
+    REQUIRE(it == polygons.end());
+}
+
+TEST_CASE("WKBView of a nested geometry collection") {
+    wkbhpp::WKBWriter writer{0};
+    const std::string point = writer.make_point(1.0, 2.0);
+
+    std::string inner = ndr_header(7);
+    wkbhpp::str_push(inner, static_cast<uint32_t>(2));
+    inner += point;
+    inner += point;
+
+    std::string wkb = ndr_header(7);
+    wkbhpp::str_push(wkb, static_cast<uint32_t>(2));
+    wkb += inner;
+    wkb += point;
+    wkb += "trailing data";
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(view.size() == wkb.size() - 13);
+
+    const auto members = view.geometries();
+    auto it = members.begin();
+    REQUIRE(it->type() == wkbhpp::geometry_type::geometrycollection);
+    REQUIRE(it->size() == inner.size());
+    REQUIRE(it->geometries().size() == 2);
+    ++it;
+    REQUIRE(it->point().y() == 2.0);
+}
+
+TEST_CASE("WKBView with Z and M coordinates") {
+    // ISO type code 3001: Point ZM
+    std::string iso = ndr_header(3001);
+    for (const double c : {1.0, 2.0, 3.0, 4.0}) {
+        wkbhpp::str_push(iso, c);
+    }
+    const wkbhpp::WKBView zm{iso};
+    REQUIRE(zm.has_z());
+    REQUIRE(zm.has_m());
+    REQUIRE(zm.point().z() == 3.0);
+    REQUIRE(zm.point().m() == 4.0);
+
+    // EWKB LineString M
+    std::string ewkb = ndr_header(0x40000002);
+    wkbhpp::str_push(ewkb, static_cast<uint32_t>(2));
+    for (const double c : {1.0, 2.0, 5.0, 3.0, 4.0, 6.0}) {
+        wkbhpp::str_push(ewkb, c);
+    }
+    const wkbhpp::WKBView m{ewkb};
+    REQUIRE_FALSE(m.has_z());
+    REQUIRE(m.has_m());
+    REQUIRE(m.points()[1].x() == 3.0);
+    REQUIRE(m.points()[1].m() == 6.0);
+    REQUIRE(std::isnan(m.points()[1].z()));
+}
+
+TEST_CASE("WKBView rejects invalid input") {
+    wkbhpp::WKBWriter writer{0};
+    writer.linestring_start();
+    writer.linestring_add_location(1.0, 2.0);
+    writer.linestring_add_location(3.0, 4.0);
+    const std::string wkb = writer.linestring_finish(2);
+
+    for (std::size_t size = 0; size < wkb.size(); ++size) {
+        REQUIRE_THROWS_AS(wkbhpp::WKBView(wkb.data(), size), const wkbhpp::wkb_error&);
+    }
+
+    std::string marker{wkb};
+    marker[0] = 2;
+    REQUIRE_THROWS_AS(wkbhpp::WKBView{marker}, const wkbhpp::wkb_error&);
+
+    REQUIRE_THROWS_AS(wkbhpp::WKBView{ndr_header(8)}, const wkbhpp::wkb_error&);
+
+    // a huge number of points must not overflow the size check
+    std::string count = ndr_header(2);
+    wkbhpp::str_push(count, static_cast<uint32_t>(0xffffffff));
+    REQUIRE_THROWS_AS(wkbhpp::WKBView{count}, const wkbhpp::wkb_error&);
+}
@@ -1,9 +1,13 @@
 #include "catch.hpp"
 
+#include <wkbhpp/validate.hpp>
+#include <wkbhpp/wkbview.hpp>
 #include <wkbhpp/wkbwriter.hpp>
 
 #include <array>
+#include <cmath>
 #include <string>
+#include <vector>
 
 constexpr int chars_per_byte = 2;
 constexpr int point_size = 2 * sizeof(double);
@@ -400,4 +404,685 @@ TEST_CASE("WKB geometry factory (byte-order-dependent): multipolygon in WKB") {
     REQUIRE(wkb.length() == 231 * chars_per_byte);
 }
 
+
+TEST_CASE("linestring_finish appending to a caller-owned buffer") {
+    wkbhpp::WKBWriter factory{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex};
+    const std::string expected{add_linestring_points(factory)};
+
+    std::string out{"prefix"};
+    for (int i = 0; i < 2; ++i) {
+        factory.linestring_start();
+        factory.linestring_add_location(3.2, 4.2);
+        factory.linestring_add_location(3.5, 4.7);
+        factory.linestring_add_location(3.6, 4.9);
+        factory.linestring_finish(3, out);
+    }
+    REQUIRE(out == "prefix" + expected + expected);
+}
+
+TEST_CASE("polygon_finish and multipolygon_finish appending to a caller-owned buffer") {
+    wkbhpp::WKBWriter factory{4326, wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary};
+    std::string out;
+
+    factory.polygon_start();
+    factory.polygon_outer_ring_start();
+    factory.polygon_add_location(3.2, 4.2);
+    factory.polygon_add_location(3.5, 4.7);
+    factory.polygon_add_location(3.6, 4.9);
+    factory.polygon_add_location(3.2, 4.2);
+    factory.polygon_outer_ring_finish();
+    factory.polygon_finish(out);
+    REQUIRE(out.size() == 77);
+    REQUIRE(out[0] == 1);
+    REQUIRE(out[1] == 3);
+
+    factory.multipolygon_start();
+    factory.multipolygon_polygon_start();
+    factory.multipolygon_outer_ring_start();
+    factory.multipolygon_add_location(3.2, 4.2);
+    factory.multipolygon_add_location(3.5, 4.7);
+    factory.multipolygon_add_location(3.0, 4.9);
+    factory.multipolygon_add_location(3.2, 4.2);
+    factory.multipolygon_outer_ring_finish();
+    factory.multipolygon_polygon_finish();
+    factory.multipolygon_finish(out);
+    REQUIRE(out.size() == 77 + 86);
+    REQUIRE(out[77] == 1);
+    REQUIRE(out[78] == 6);
+    // the polygon inside the multipolygon is identical to the polygon above
+    REQUIRE(out.substr(86, 9) == out.substr(0, 9));
+}
+
+
+std::string add_multipolygon(wkbhpp::WKBWriter& writer) {
+    writer.multipolygon_start();
+    writer.multipolygon_polygon_start();
+    writer.multipolygon_outer_ring_start();
+    writer.multipolygon_add_location(13.2, 4.2);
+    writer.multipolygon_add_location(13.5, 4.7);
+    writer.multipolygon_add_location(13.0, 4.9);
+    writer.multipolygon_add_location(13.2, 4.2);
+    writer.multipolygon_outer_ring_finish();
+    writer.multipolygon_inner_ring_start();
+    writer.multipolygon_add_location(13.25, 4.25);
+    writer.multipolygon_add_location(13.05, 4.85);
+    writer.multipolygon_add_location(13.45, 4.65);
+    writer.multipolygon_add_location(13.25, 4.25);
+    writer.multipolygon_inner_ring_finish();
+    writer.multipolygon_polygon_finish();
+    return writer.multipolygon_finish();
+}
+
+TEST_CASE("HEX output is identical to HEX conversion of binary output") {
+    for (const auto wtype : {wkbhpp::wkb_type::wkb, wkbhpp::wkb_type::ewkb}) {
+        wkbhpp::WKBWriter binary{3857, wtype, wkbhpp::out_type::binary};
+        wkbhpp::WKBWriter hex{3857, wtype, wkbhpp::out_type::hex};
+
+        REQUIRE(hex.make_point(356222, 467961) == wkbhpp::convert_to_hex(binary.make_point(356222, 467961)));
+        REQUIRE(add_linestring_points(hex) == wkbhpp::convert_to_hex(add_linestring_points(binary)));
+        REQUIRE(add_multipolygon(hex) == wkbhpp::convert_to_hex(add_multipolygon(binary)));
+    }
+}
+
+
+TEST_CASE("Bulk adding of locations is identical to adding single locations") {
+    std::vector<double> xy;
+    std::vector<double> x;
+    std::vector<double> y;
+    for (int i = 0; i < 37; ++i) {
+        x.push_back(i * 1.5);
+        y.push_back(i * -0.25);
+        xy.push_back(x.back());
+        xy.push_back(y.back());
+    }
+
+    for (const auto otype : {wkbhpp::out_type::binary, wkbhpp::out_type::hex}) {
+        wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb, otype};
+
+        writer.linestring_start();
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            writer.linestring_add_location(x[i], y[i]);
+        }
+        const std::string expected{writer.linestring_finish(x.size())};
+
+        writer.linestring_start();
+        writer.linestring_add_locations(xy.data(), 5);
+        writer.linestring_add_locations(xy.data() + 10, x.size() - 5);
+        REQUIRE(writer.linestring_finish(x.size()) == expected);
+
+        writer.linestring_start();
+        writer.linestring_add_locations(x.data(), y.data(), 4);
+        writer.linestring_add_locations(x.data() + 4, y.data() + 4, x.size() - 4);
+        REQUIRE(writer.linestring_finish(x.size()) == expected);
+    }
+}
+
+TEST_CASE("Bulk adding of locations to rings counts the points") {
+    const double xy[] = {0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 0.0};
+    const double x[] = {0.0, 1.0, 1.0, 0.0};
+    const double y[] = {0.0, 0.0, 1.0, 0.0};
+
+    for (const auto otype : {wkbhpp::out_type::binary, wkbhpp::out_type::hex}) {
+        wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::wkb, otype};
+
+        writer.multipolygon_start();
+        writer.multipolygon_polygon_start();
+        writer.multipolygon_outer_ring_start();
+        for (int i = 0; i < 4; ++i) {
+            writer.multipolygon_add_location(x[i], y[i]);
+        }
+        writer.multipolygon_outer_ring_finish();
+        writer.multipolygon_polygon_finish();
+        const std::string expected{writer.multipolygon_finish()};
+
+        writer.multipolygon_start();
+        writer.multipolygon_polygon_start();
+        writer.multipolygon_outer_ring_start();
+        writer.multipolygon_add_locations(xy, 1);
+        writer.multipolygon_add_locations(xy + 2, 3);
+        writer.multipolygon_outer_ring_finish();
+        writer.multipolygon_polygon_finish();
+        REQUIRE(writer.multipolygon_finish() == expected);
+
+        writer.multipolygon_start();
+        writer.multipolygon_polygon_start();
+        writer.multipolygon_outer_ring_start();
+        writer.multipolygon_add_locations(x, y, 4);
+        writer.multipolygon_outer_ring_finish();
+        writer.multipolygon_polygon_finish();
+        REQUIRE(writer.multipolygon_finish() == expected);
+
+        writer.polygon_start();
+        writer.polygon_outer_ring_start();
+        writer.polygon_add_locations(x, y, 4);
+        writer.polygon_outer_ring_finish();
+        const std::string polygon{writer.polygon_finish()};
+        const std::size_t chars = otype == wkbhpp::out_type::hex ? 2 : 1;
+        REQUIRE(polygon == expected.substr(9 * chars));
+    }
+}
+
 #endif
+
+template <wkbhpp::wkb_type TWkbType, wkbhpp::out_type TOutType>
+void check_static_writer() {
+    wkbhpp::BasicWKBWriter<TWkbType, TOutType> static_writer{3857};
+    wkbhpp::WKBWriter writer{3857, TWkbType, TOutType};
+
+    REQUIRE(static_writer.make_point(1.5, -2.5) == writer.make_point(1.5, -2.5));
+    std::string out{"x"};
+    static_writer.make_point(1.5, -2.5, out);
+    REQUIRE(out == "x" + writer.make_point(1.5, -2.5));
+
+    const std::vector<std::pair<double, double>> points{{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}, {1.0, 2.0}};
+    REQUIRE(static_writer.make_linestring(points) == writer.make_linestring(points));
+
+    const std::vector<std::vector<std::pair<double, double>>> rings{points, points};
+    REQUIRE(static_writer.make_polygon(rings) == writer.make_polygon(rings));
+}
+
+TEST_CASE("BasicWKBWriter creates the same output as WKBWriter") {
+    check_static_writer<wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary>();
+    check_static_writer<wkbhpp::wkb_type::wkb, wkbhpp::out_type::hex>();
+    check_static_writer<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary>();
+    check_static_writer<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex>();
+}
+
+TEST_CASE("BasicWKBWriter with big endian output") {
+    wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex, wkbhpp::byte_order::xdr> writer{4326};
+
+    REQUIRE(writer.make_point(1.0, 2.0) == "0020000001000010E63FF00000000000004000000000000000");
+
+    const double xy[] = {1.0, 2.0, -2.0, 0.5};
+    const double x[] = {1.0, -2.0};
+    const double y[] = {2.0, 0.5};
+    const std::string expected{"0020000002000010E6000000023FF0000000000000400000000000000"
+                               "0C0000000000000003FE0000000000000"};
+
+    writer.linestring_start();
+    writer.linestring_add_location(1.0, 2.0);
+    writer.linestring_add_location(-2.0, 0.5);
+    REQUIRE(writer.linestring_finish(2) == expected);
+
+    writer.linestring_start();
+    writer.linestring_add_locations(xy, 2);
+    REQUIRE(writer.linestring_finish(2) == expected);
+
+    writer.linestring_start();
+    writer.linestring_add_locations(x, y, 2);
+    REQUIRE(writer.linestring_finish(2) == expected);
+}
+
+TEST_CASE("make_point_array has the exact size of a point") {
+    static_assert(std::tuple_size<decltype(wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary>{0}.make_point_array(0, 0))>::value == 21, "WKB");
+    static_assert(std::tuple_size<decltype(wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary>{0}.make_point_array(0, 0))>::value == 25, "EWKB");
+    static_assert(std::tuple_size<decltype(wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::wkb, wkbhpp::out_type::hex>{0}.make_point_array(0, 0))>::value == 42, "WKB HEX");
+    static_assert(std::tuple_size<decltype(wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex>{0}.make_point_array(0, 0))>::value == 50, "EWKB HEX");
+
+    wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex> writer{4326};
+    const auto point = writer.make_point_array(3.2, 4.2);
+    REQUIRE(std::string(point.data(), point.size()) == writer.make_point(3.2, 4.2));
+
+    wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary, wkbhpp::byte_order::xdr> xdr_writer{4326};
+    const auto xdr_point = xdr_writer.make_point_array(3.2, 4.2);
+    REQUIRE(std::string(xdr_point.data(), xdr_point.size()) == xdr_writer.make_point(3.2, 4.2));
+}
+
+TEST_CASE("make_point_into writes the point to a caller-provided buffer") {
+    for (const auto wtype : {wkbhpp::wkb_type::wkb, wkbhpp::wkb_type::ewkb}) {
+        for (const auto otype : {wkbhpp::out_type::binary, wkbhpp::out_type::hex}) {
+            wkbhpp::WKBWriter writer{3857, wtype, otype};
+            char buffer[wkbhpp::WKBWriter::max_point_size];
+            const std::size_t size = writer.make_point_into(356222, 467961, buffer);
+            REQUIRE(size == writer.point_size());
+            REQUIRE(std::string(buffer, size) == writer.make_point(356222, 467961));
+        }
+    }
+}
+
+template <typename TWriter>
+void check_encode_points(const TWriter& writer) {
+    std::vector<double> xy;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::string expected{"prefix"};
+    for (int i = 0; i < 150; ++i) {
+        x.push_back(i * 0.75);
+        y.push_back(-i * 1.25);
+        xy.push_back(x.back());
+        xy.push_back(y.back());
+        expected += writer.make_point(x.back(), y.back());
+    }
+
+    std::string out{"prefix"};
+    std::vector<std::size_t> offsets(x.size() + 1);
+    writer.encode_points(xy.data(), x.size(), out, offsets.data());
+    REQUIRE(out == expected);
+    REQUIRE(offsets.front() == 6);
+    REQUIRE(offsets.back() == out.size());
+    REQUIRE(out.substr(offsets[17], offsets[18] - offsets[17]) == writer.make_point(x[17], y[17]));
+
+    out = "prefix";
+    writer.encode_points(x.data(), y.data(), x.size(), out);
+    REQUIRE(out == expected);
+}
+
+TEST_CASE("encode_points creates point records back to back") {
+    for (const auto wtype : {wkbhpp::wkb_type::wkb, wkbhpp::wkb_type::ewkb}) {
+        for (const auto otype : {wkbhpp::out_type::binary, wkbhpp::out_type::hex}) {
+            check_encode_points(wkbhpp::WKBWriter{3857, wtype, otype});
+        }
+    }
+    check_encode_points(wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex>{4326});
+    check_encode_points(wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary, wkbhpp::byte_order::xdr>{4326});
+    check_encode_points(wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex, wkbhpp::byte_order::xdr>{4326});
+}
+
+TEST_CASE("MultiPoint") {
+    wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::wkb, wkbhpp::out_type::hex, wkbhpp::byte_order::xdr> writer{4326};
+    writer.multipoint_start();
+    writer.multipoint_add_location(1.0, 2.0);
+    writer.multipoint_add_location(3.0, 4.0);
+    REQUIRE(writer.multipoint_finish() ==
+            "000000000400000002"
+            "00000000013FF00000000000004000000000000000"
+            "000000000140080000000000004010000000000000");
+
+    const std::vector<double> xy{1.0, 2.0, 3.0, 4.0};
+    writer.multipoint_start();
+    writer.multipoint_add_locations(xy.data(), 2);
+    std::string out;
+    writer.multipoint_finish(out);
+    REQUIRE(out ==
+            "000000000400000002"
+            "00000000013FF00000000000004000000000000000"
+            "000000000140080000000000004010000000000000");
+}
+
+TEST_CASE("MultiLineString") {
+    wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::wkb, wkbhpp::out_type::hex, wkbhpp::byte_order::xdr> writer{4326};
+    writer.multilinestring_start();
+    writer.multilinestring_linestring_start();
+    writer.multilinestring_add_location(1.0, 2.0);
+    writer.multilinestring_add_location(3.0, 4.0);
+    writer.multilinestring_linestring_finish();
+    writer.multilinestring_linestring_start();
+    const std::vector<double> xy{5.0, 6.0};
+    writer.multilinestring_add_locations(xy.data(), 1);
+    writer.multilinestring_linestring_finish();
+    REQUIRE(writer.multilinestring_finish() ==
+            "000000000500000002"
+            "000000000200000002"
+            "3FF00000000000004000000000000000"
+            "40080000000000004010000000000000"
+            "000000000200000001"
+            "40140000000000004018000000000000");
+}
+
+TEST_CASE("GeometryCollection") {
+    wkbhpp::BasicWKBWriter<wkbhpp::wkb_type::wkb, wkbhpp::out_type::hex, wkbhpp::byte_order::xdr> writer{4326};
+
+    SECTION("empty") {
+        writer.geometrycollection_start();
+        REQUIRE(writer.geometrycollection_finish() == "000000000700000000");
+    }
+
+    SECTION("members of all types") {
+        writer.geometrycollection_start();
+        writer.geometrycollection_add_point(1.0, 2.0);
+        writer.linestring_start();
+        writer.linestring_add_location(3.0, 4.0);
+        REQUIRE(writer.linestring_finish(1).empty());
+        writer.geometrycollection_start();
+        writer.polygon_start();
+        writer.polygon_outer_ring_start();
+        writer.polygon_add_location(5.0, 6.0);
+        writer.polygon_outer_ring_finish();
+        std::string out;
+        writer.polygon_finish(out);
+        REQUIRE(out.empty());
+        writer.geometrycollection_finish();
+        REQUIRE(writer.geometrycollection_finish() ==
+                "000000000700000003"
+                "00000000013FF00000000000004000000000000000"
+                "000000000200000001"
+                "40080000000000004010000000000000"
+                "000000000700000001"
+                "00000000030000000100000001"
+                "40140000000000004018000000000000");
+
+        // the next geometry starts a new output
+        REQUIRE(writer.make_linestring(std::vector<std::pair<double, double>>{{1.0, 2.0}}) ==
+                "000000000200000001"
+                "3FF00000000000004000000000000000");
+    }
+
+    SECTION("nested too deeply") {
+        // a multipolygon, its polygon and ring fit into the innermost
+        // collection, but not more
+        for (std::size_t i = 0; i < wkbhpp::max_collection_depth; ++i) {
+            writer.geometrycollection_start();
+        }
+        writer.multipolygon_start();
+        writer.multipolygon_polygon_start();
+        REQUIRE_THROWS_AS(writer.multipolygon_outer_ring_start(), const wkbhpp::wkb_error&);
+    }
+}
+
+TEST_CASE("Points with Z and M use ISO type codes in WKB") {
+    using wkbhpp::wkb_type;
+    using wkbhpp::out_type;
+    using wkbhpp::byte_order;
+    using wkbhpp::dimensions;
+
+    wkbhpp::BasicWKBWriter<wkb_type::wkb, out_type::hex, byte_order::xdr, dimensions::xyz> writer_z{4326};
+    REQUIRE(writer_z.make_point(1.0, 2.0, 3.0) ==
+            "00000003E9"
+            "3FF000000000000040000000000000004008000000000000");
+
+    wkbhpp::BasicWKBWriter<wkb_type::wkb, out_type::hex, byte_order::xdr, dimensions::xym> writer_m{4326};
+    REQUIRE(writer_m.make_point(1.0, 2.0, 3.0) ==
+            "00000007D1"
+            "3FF000000000000040000000000000004008000000000000");
+
+    wkbhpp::BasicWKBWriter<wkb_type::wkb, out_type::hex, byte_order::xdr, dimensions::xyzm> writer_zm{4326};
+    REQUIRE(writer_zm.make_point(1.0, 2.0, 3.0, 4.0) ==
+            "0000000BB9"
+            "3FF0000000000000400000000000000040080000000000004010000000000000");
+    REQUIRE(writer_zm.point_size() == 2 * (5 + 4 * sizeof(double)));
+}
+
+TEST_CASE("Points with Z and M use flags in EWKB") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex, wkbhpp::byte_order::xdr,
+                             wkbhpp::dimensions::xyzm};
+    REQUIRE(writer.make_point(1.0, 2.0, 3.0, 4.0) ==
+            "00E0000001000010E6"
+            "3FF0000000000000400000000000000040080000000000004010000000000000");
+
+    wkbhpp::WKBWriter writer_z{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::hex, wkbhpp::byte_order::xdr,
+                               wkbhpp::dimensions::xyz};
+    writer_z.linestring_start();
+    writer_z.linestring_add_location(1.0, 2.0, 3.0);
+    REQUIRE(writer_z.linestring_finish(1) ==
+            "00A0000002000010E600000001"
+            "3FF000000000000040000000000000004008000000000000");
+}
+
+TEST_CASE("Bulk adding of 3D and 4D locations is identical to adding single locations") {
+    const std::vector<double> xyz{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0};
+    const std::vector<double> xyzm{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+
+    for (const auto order : {wkbhpp::byte_order::ndr, wkbhpp::byte_order::xdr}) {
+        for (const auto otype : {wkbhpp::out_type::binary, wkbhpp::out_type::hex}) {
+            wkbhpp::WKBWriter writer_z{4326, wkbhpp::wkb_type::ewkb, otype, order, wkbhpp::dimensions::xyz};
+            writer_z.linestring_start();
+            writer_z.linestring_add_locations(xyz.data(), 3);
+            const std::string bulk_z = writer_z.linestring_finish(3);
+            writer_z.linestring_start();
+            for (std::size_t i = 0; i < xyz.size(); i += 3) {
+                writer_z.linestring_add_location(xyz[i], xyz[i + 1], xyz[i + 2]);
+            }
+            REQUIRE(bulk_z == writer_z.linestring_finish(3));
+
+            wkbhpp::WKBWriter writer_zm{4326, wkbhpp::wkb_type::wkb, otype, order, wkbhpp::dimensions::xyzm};
+            writer_zm.multipoint_start();
+            writer_zm.multipoint_add_locations(xyzm.data(), 2);
+            const std::string bulk_zm = writer_zm.multipoint_finish();
+            writer_zm.multipoint_start();
+            writer_zm.multipoint_add_location(1.0, 2.0, 3.0, 4.0);
+            writer_zm.multipoint_add_location(5.0, 6.0, 7.0, 8.0);
+            REQUIRE(bulk_zm == writer_zm.multipoint_finish());
+        }
+    }
+}
+
+TEST_CASE("Geometries with Z and M can be read back") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb, wkbhpp::out_type::binary, wkbhpp::byte_order::xdr,
+                             wkbhpp::dimensions::xyzm};
+    writer.polygon_start();
+    writer.polygon_outer_ring_start();
+    writer.polygon_add_location(0.0, 0.0, 1.0, 2.0);
+    writer.polygon_add_location(1.0, 0.0, 3.0, 4.0);
+    writer.polygon_add_location(0.0, 1.0, 5.0, 6.0);
+    writer.polygon_add_location(0.0, 0.0, 1.0, 2.0);
+    writer.polygon_outer_ring_finish();
+    const std::string wkb = writer.polygon_finish();
+    REQUIRE(wkbhpp::validate(wkb.data(), wkb.size()) == wkbhpp::wkb_status::ok);
+
+    const wkbhpp::WKBView view{wkb};
+    REQUIRE(view.has_z());
+    REQUIRE(view.has_m());
+    const auto ring = *view.rings().begin();
+    REQUIRE(ring.size() == 4);
+    REQUIRE(ring[1].x() == 1.0);
+    REQUIRE(ring[1].z() == 3.0);
+    REQUIRE(ring[1].m() == 4.0);
+}
+
+TEST_CASE("Coordinates not matching the dimensions of the writer") {
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::wkb, wkbhpp::out_type::binary, wkbhpp::native_byte_order,
+                             wkbhpp::dimensions::xyz};
+    REQUIRE_THROWS_AS(writer.make_point(1.0, 2.0), const wkbhpp::wkb_error&);
+    REQUIRE_THROWS_AS(writer.make_point(1.0, 2.0, 3.0, 4.0), const wkbhpp::wkb_error&);
+
+    char buffer[wkbhpp::WKBWriter::max_point_size];
+    REQUIRE_THROWS_AS(writer.make_point_into(1.0, 2.0, buffer), const wkbhpp::wkb_error&);
+
+    const std::vector<std::pair<double, double>> points{{1.0, 2.0}};
+    REQUIRE_THROWS_AS(writer.make_linestring(points), const wkbhpp::wkb_error&);
+}
+
+TEST_CASE("reverse_records reverses the order of records") {
+    for (const std::size_t size : {8, 16, 24, 32, 48, 64}) {
+        for (std::size_t count = 0; count < 8; ++count) {
+            std::string data(size * count, '\0');
+            for (std::size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<char>(i);
+            }
+            std::string expected;
+            for (std::size_t i = count; i > 0; --i) {
+                expected.append(data, (i - 1) * size, size);
+            }
+            wkbhpp::detail::reverse_records(&data[0], count, size);
+            REQUIRE(data == expected);
+        }
+    }
+}
+
+TEST_CASE("Rings are reversed in place to the wanted orientation") {
+    // outer ring clockwise, inner ring counterclockwise
+    const std::vector<double> outer{0.0, 0.0, 0.0, 4.0, 4.0, 4.0, 4.0, 0.0, 0.0, 0.0};
+    const std::vector<double> inner{1.0, 1.0, 2.0, 1.0, 2.0, 2.0, 1.0, 1.0};
+
+    const auto reversed = [](const std::vector<double>& ring, std::size_t stride) {
+        std::vector<double> result;
+        for (std::size_t i = ring.size(); i > 0; i -= stride) {
+            result.insert(result.end(), ring.begin() + (i - stride), ring.begin() + i);
+        }
+        return result;
+    };
+    const auto with_z = [](const std::vector<double>& ring) {
+        std::vector<double> result;
+        for (std::size_t i = 0; i < ring.size(); i += 2) {
+            result.insert(result.end(), {ring[i], ring[i + 1], static_cast<double>(i)});
+        }
+        return result;
+    };
+
+    for (const auto order : {wkbhpp::byte_order::ndr, wkbhpp::byte_order::xdr}) {
+        for (const auto otype : {wkbhpp::out_type::binary, wkbhpp::out_type::hex}) {
+            for (const auto dims : {wkbhpp::dimensions::xy, wkbhpp::dimensions::xyz}) {
+                const std::size_t stride = wkbhpp::stride(dims);
+                const auto o = stride == 2 ? outer : with_z(outer);
+                const auto i = stride == 2 ? inner : with_z(inner);
+
+                wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb, otype, order, dims};
+                const auto make = [&](const std::vector<double>& o_ring, const std::vector<double>& i_ring) {
+                    writer.multipolygon_start();
+                    writer.multipolygon_polygon_start();
+                    writer.multipolygon_outer_ring_start();
+                    writer.multipolygon_add_locations(o_ring.data(), o_ring.size() / stride);
+                    writer.multipolygon_outer_ring_finish();
+                    writer.multipolygon_inner_ring_start();
+                    writer.multipolygon_add_locations(i_ring.data(), i_ring.size() / stride);
+                    writer.multipolygon_inner_ring_finish();
+                    writer.multipolygon_polygon_finish();
+                    return writer.multipolygon_finish();
+                };
+
+                const std::string as_given = make(o, i);
+                const std::string flipped = make(reversed(o, stride), reversed(i, stride));
+                REQUIRE(as_given != flipped);
+
+                writer.set_ring_orientation(wkbhpp::ring_orientation::ccw, wkbhpp::ring_orientation::cw);
+                REQUIRE(make(o, i) == flipped);
+                REQUIRE(make(reversed(o, stride), reversed(i, stride)) == flipped);
+
+                writer.set_ring_orientation(wkbhpp::ring_orientation::cw, wkbhpp::ring_orientation::ccw);
+                REQUIRE(make(o, i) == as_given);
+                REQUIRE(make(reversed(o, stride), reversed(i, stride)) == as_given);
+            }
+        }
+    }
+}
+
+TEST_CASE("Ring orientation of polygons with many points") {
+    // counterclockwise circle with more points than fit into one block
+    std::vector<std::pair<double, double>> ring;
+    for (int i = 0; i < 200; ++i) {
+        ring.emplace_back(std::cos(i * 0.0314), std::sin(i * 0.0314));
+    }
+    ring.push_back(ring.front());
+    std::vector<std::pair<double, double>> reversed_ring{ring.rbegin(), ring.rend()};
+
+    wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::wkb, wkbhpp::out_type::hex};
+    const std::string ccw = writer.make_polygon(std::vector<decltype(ring)>{ring});
+    writer.set_ring_orientation(wkbhpp::ring_orientation::ccw, wkbhpp::ring_orientation::cw);
+    REQUIRE(writer.make_polygon(std::vector<decltype(ring)>{reversed_ring}) == ccw);
+}
+
+namespace {
+
+    template <typename TWriter>
+    void add_square(TWriter& writer, double x, double y, bool member, bool hole) {
+        const std::vector<double> outer{x, y, x + 2, y, x + 2, y + 2, x, y + 2, x, y};
+        const std::vector<double> inner{x + 0.5, y + 0.5, x + 0.5, y + 1, x + 1, y + 1, x + 0.5, y + 0.5};
+        if (member) {
+            writer.multipolygon_polygon_start();
+            writer.multipolygon_outer_ring_start();
+            writer.multipolygon_add_locations(outer.data(), 5);
+            writer.multipolygon_outer_ring_finish();
+            if (hole) {
+                writer.multipolygon_inner_ring_start();
+                writer.multipolygon_add_locations(inner.data(), 4);
+                writer.multipolygon_inner_ring_finish();
+            }
+            writer.multipolygon_polygon_finish();
+        } else {
+            writer.polygon_start();
+            writer.polygon_outer_ring_start();
+            writer.polygon_add_locations(outer.data(), 5);
+            writer.polygon_outer_ring_finish();
+            if (hole) {
+                writer.polygon_inner_ring_start();
+                writer.polygon_add_locations(inner.data(), 4);
+                writer.polygon_inner_ring_finish();
+            }
+        }
+    }
+
+} // anonymous namespace
+
+TEST_CASE("Explode mode writes each polygon of a MultiPolygon as a geometry") {
+    for (const auto otype : {wkbhpp::out_type::binary, wkbhpp::out_type::hex}) {
+        wkbhpp::WKBWriter writer{4326, wkbhpp::wkb_type::ewkb, otype};
+
+        add_square(writer, 0.0, 0.0, false, true);
+        const std::string first = writer.polygon_finish();
+        add_square(writer, 5.0, 0.0, false, false);
+        const std::string second = writer.polygon_finish();
+
+        writer.multipolygon_start();
+        add_square(writer, 0.0, 0.0, true, true);
+        add_square(writer, 5.0, 0.0, true, false);
+        const std::string whole = writer.multipolygon_finish();
+
+        // the polygons must be recorded when they are added
+        writer.multipolygon_start();
+        add_square(writer, 0.0, 0.0, true, true);
+        std::string batch;
+        std::vector<uint32_t> offsets;
+        REQUIRE_THROWS_AS(writer.multipolygon_finish(batch, offsets), const wkbhpp::wkb_error&);
+        REQUIRE(batch.empty());
+        writer.multipolygon_finish();
+
+        writer.set_explode(true);
+        batch = "prefix";
+        for (int i = 0; i < 2; ++i) {
+            writer.multipolygon_start();
+            add_square(writer, 0.0, 0.0, true, true);
+            add_square(writer, 5.0, 0.0, true, false);
+            std::string out;
+            writer.multipolygon_finish(batch, offsets, out);
+            REQUIRE(out == whole);
+        }
+        // a MultiPolygon without polygons adds nothing
+        writer.multipolygon_start();
+        writer.multipolygon_finish(batch, offsets);
+
+        const uint32_t a = first.size();
+        const uint32_t b = second.size();
+        REQUIRE(offsets == (std::vector<uint32_t>{6, 6 + a, 6 + a + b, 6 + 2 * a + b, 6 + 2 * a + 2 * b}));
+        REQUIRE(batch == "prefix" + first + second + first + second);
+        if (otype == wkbhpp::out_type::binary) {
+            REQUIRE(wkbhpp::validate(batch.data(), offsets.data(), offsets.size() - 1).empty());
+        }
+
+        // the normal finish methods still work in explode mode
+        writer.multipolygon_start();
+        add_square(writer, 0.0, 0.0, true, true);
+        add_square(writer, 5.0, 0.0, true, false);
+        REQUIRE(writer.multipolygon_finish() == whole);
+    }
+}
+
+TEST_CASE("Starting a geometry discards an unfinished one") {
+    wkbhpp::WKBWriter writer{4326};
+    writer.linestring_start();
+    writer.linestring_add_location(1.0, 2.0);
+    writer.linestring_add_location(3.0, 4.0);
+    const std::string expected = writer.linestring_finish(2);
+    REQUIRE(expected.size() == 41);
+
+    // like a caller giving up on a way with too few points
+    writer.linestring_start();
+    writer.linestring_add_location(1.0, 2.0);
+    writer.linestring_start();
+    writer.linestring_add_location(1.0, 2.0);
+    writer.linestring_add_location(3.0, 4.0);
+    REQUIRE(writer.linestring_finish(2) == expected);
+
+    writer.multipolygon_start();
+    writer.multipolygon_polygon_start();
+    writer.multipolygon_outer_ring_start();
+    writer.linestring_start();
+    writer.linestring_add_location(1.0, 2.0);
+    writer.linestring_add_location(3.0, 4.0);
+    REQUIRE(writer.linestring_finish(2) == expected);
+
+    // members of an open GeometryCollection are not affected
+    writer.geometrycollection_start();
+    writer.linestring_start();
+    writer.linestring_add_location(1.0, 2.0);
+    writer.linestring_add_location(3.0, 4.0);
+    writer.linestring_finish(2);
+    const std::string collection = writer.geometrycollection_finish();
+    REQUIRE(collection.size() == 1 + 2 * 4 + expected.size());
+    REQUIRE(collection.substr(9) == expected);
+
+    // reset() discards explicitly
+    writer.polygon_start();
+    writer.reset();
+    writer.geometrycollection_start();
+    REQUIRE(writer.geometrycollection_finish().size() == 9);
+}